@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+#include "wordstore.h"
+#include "wordprovider.h"
+
+namespace Crossword
+{
+  class BinaryWordProvider : public WordProvider
+  {
+  private:
+    std::string m_location;
+
+  public:
+    /**
+       Constructs a new crossword word provider that reads words from a binary
+       word list file, see WordStore::save_binary(...).
+       @param location The binary word list file name.
+     */
+    BinaryWordProvider(const std::string &location);
+
+    /**
+       Maps the binary word list file specified in the constructor call into
+       memory. If words is empty, it uses the mapped words without copying them,
+       otherwise they are appended.
+       @param words The word store to which the retrieved words are appended to.
+     */
+    void retrieve_word_list(WordStore &words) const override;
+  };
+}
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
-#include "word.h"
+#include "wordstore.h"
 #include "wordprovider.h"
 
 namespace Crossword
@@ -14,6 +16,17 @@ namespace Crossword
     bool m_ignore_header;
     char m_delim;
 
+    // Files are split into chunks of at least this size, parsed in parallel.
+    static constexpr std::size_t MIN_CHUNK_SIZE = 4 << 20;
+
+    /**
+       Parses all records starting in [begin, end) of data and adds their words
+       to words. The last record may end behind end.
+       @return the position after the last parsed record.
+     */
+    std::size_t parse_records(std::string_view data, std::size_t begin, std::size_t end,
+                              WordStore &words) const;
+
   public:
     /**
        Constructs a new crossword word provider that reads words from a CSV file.
@@ -26,9 +39,16 @@ namespace Crossword
 
     /**
        Retrieves a list of crossword words from the CSV file specified in
-       the constructor call and appends it to a WordList.
-       @param wordlist The word list to which the retrieved words are appended to.
+       the constructor call and appends it to a WordStore.
+       @param words The word store to which the retrieved words are appended to.
+     */
+    void retrieve_word_list(WordStore &words) const override;
+
+    /**
+       Like retrieve_word_list(words), but splits the file into chunk_count
+       chunks parsed in parallel. If chunk_count is 0, it is chosen by the file
+       size and the number of hardware threads.
      */
-    void retrieve_word_list(WordList &wordlist) const override;
+    void retrieve_word_list(WordStore &words, std::size_t chunk_count) const;
   };
 }
\ No newline at end of file
@@ -1,58 +1,246 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <random>
+#include <functional>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "wordprovider.h"
 #include "scorer.h"
 #include "grid.h"
+#include "placementcache.h"
+#include "placementstrategy.h"
+#include "random.h"
+
+#include "INIReader.h"
 
 namespace Crossword
 {
+    /**
+        Bounded multi-producer/single-consumer ring buffer used to hand generated
+        grids from the worker threads to the grid processing thread.
+
+        Every slot carries an atomic sequence number that tells producers and the
+        consumer whether the slot is free or filled for the current lap. Slots are
+        padded to a cache line so that producers filling neighbouring slots do not
+        invalidate each other's cache lines. Threads that find the buffer full
+        (producers) or empty (consumer) back off and eventually sleep instead of
+        spinning.
+     */
     class SharedGridBuffer
     {
     private:
-        const static int GRID_BUFFER_SIZE = 5000;
+        // must be a power of two, so that slot indices can be computed by masking
+        const static std::size_t GRID_BUFFER_SIZE = 4096;
+        const static std::size_t CACHE_LINE_SIZE = 64;
+
+        struct alignas(CACHE_LINE_SIZE) Slot
+        {
+            std::atomic<std::size_t> sequence;
+            std::int_fast32_t attempt;
+            Grid grid;
+        };
 
-        int m_number_of_threads = 0;
-        std::vector<int> m_next_filled_grids_by_thread;
-        int m_next_processed_grid = 0;
+        std::unique_ptr<Slot[]> m_slots;
 
-        Grid m_grid_buffer[GRID_BUFFER_SIZE];
-        int m_filed_grid_flags[GRID_BUFFER_SIZE];
-        int m_processed_grid_flags[GRID_BUFFER_SIZE];
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_enqueue_pos;
+        // only touched by the single consumer
+        alignas(CACHE_LINE_SIZE) std::size_t m_dequeue_pos;
+
+        std::atomic<bool> m_full_warning_printed;
 
     public:
-        SharedGridBuffer(int number_of_threads);
+        SharedGridBuffer();
+
+        /**
+            Adds a grid to the buffer. Safe to be called from multiple threads.
+            Blocks (with backoff) while the buffer is full.
+         */
+        void addNextGrid(std::int_fast32_t attempt, Grid const &grid);
 
-        void addNextGrid(int threadId, Grid const &grid);
-        Grid getNextGridToProcess();
+        /**
+            Removes and returns the oldest grid from the buffer. Must only be called
+            from a single thread. Blocks (with backoff) while the buffer is empty.
+            @param attempt Set to the attempt the returned grid was generated in.
+         */
+        Grid getNextGridToProcess(std::int_fast32_t &attempt);
 
         void clear();
     };
 
+    typedef struct ScoredGrid
+    {
+        score grid_score;
+        // attempt the grid was generated in, used to break ties between equally
+        // scored grids independently of the order in which they were offered
+        std::int_fast32_t attempt;
+        Grid grid;
+    } ScoredGrid;
+
+    /**
+        Keeps the k highest scoring grids offered to it. Not thread-safe, every
+        thread keeps its own instance and the instances are merged afterwards.
+     */
+    class BestGrids
+    {
+    private:
+        std::size_t m_capacity;
+        // min-heap on the score, i.e. the worst kept grid is at the front
+        std::vector<ScoredGrid> m_heap;
+
+    public:
+        BestGrids(std::size_t capacity);
+
+        /**
+            Checks if a grid with score grid_score would be kept by offer(...).
+            Allows to skip creating a grid snapshot that is thrown away anyway.
+         */
+        bool accepts(score grid_score, std::int_fast32_t attempt) const;
+
+        /**
+            Offers a grid. It is kept if it is among the k best grids seen so far.
+            @return true if the grid was kept, otherwise false.
+         */
+        bool offer(score grid_score, std::int_fast32_t attempt, Grid const &grid);
+
+        /**
+            Offers all grids kept by other to this instance.
+         */
+        void merge(BestGrids const &other);
+
+        bool empty() const;
+
+        /**
+            @return the kept grids, the highest scoring grid first.
+         */
+        std::vector<ScoredGrid> get_sorted() const;
+    };
+
+    enum class ScoringMode
+    {
+        // every worker scores its own grids and keeps a thread-local best
+        LOCAL,
+        // workers hand all grids to a single scoring thread via SharedGridBuffer
+        CENTRAL
+    };
+
+    enum class GenerationMode
+    {
+        // independent attempts, each building a grid from scratch
+        RESTARTS,
+        // beam search over partial grids, see Generator::generate_with_beam_search()
+        BEAM
+    };
+
+    enum class DisconnectedWords
+    {
+        // try all words, even if they can never be part of the same grid
+        ALL,
+        // only try the words of the largest crossing component
+        LARGEST_COMPONENT,
+        // refuse to generate grids if not all words can be crossed
+        FAIL
+    };
+
     class Generator
     {
     private:
         const std::int_fast32_t PRINT_PROGRESS_EVERY_GRIDS = 2500;
+        // number of attempts a worker claims at once from the shared attempt counter
+        const std::int_fast32_t ATTEMPTS_PER_CHUNK = 32;
 
-        std::default_random_engine m_rng;
+        // every attempt derives its own random generator from this seed
+        std::uint64_t m_seed;
 
         std::int_fast32_t m_gen_count;
         std::int_fast32_t m_cw_max_width;
         std::int_fast32_t m_cw_max_height;
 
-        WordList word_list;
+        int m_thread_count;
+        GenerationMode m_mode;
+        ScoringMode m_scoring_mode;
+        std::size_t m_best_grid_count;
+        // beam mode only: number of kept partial grids and of the placements each
+        // of them is expanded with
+        std::size_t m_beam_width;
+        std::size_t m_beam_expansions;
+
+        // shared with all grids, which reference the words by id
+        std::shared_ptr<WordStore const> m_word_store;
         std::unique_ptr<Scorer> m_grid_scorer;
+        std::unique_ptr<PlacementStrategy const> m_placement_strategy;
+        // words tried in every attempt, see DisconnectedWords
+        std::vector<wid> m_candidate_words;
+
+        /**
+            Memory reused by a worker thread for all its attempts.
+         */
+        typedef struct Workspace
+        {
+            Grid grid;
+            PlacementCache placement_cache;
+            std::vector<wid> unused_words;
+            std::vector<wid> unplaced_words;
+        } Workspace;
+
+        /**
+            Generates a new crossword on workspace.grid. The grid is reset before, so
+            a grid can be reused for many attempts.
+         */
+        void generate_single_grid(Rng &rng, Workspace &workspace) const;
+
+        score score_grid(Grid const &grid) const;
+
+        /**
+            Runs attempt_fun(worker, attempt) for every attempt in
+            [0, attempt_count) on m_thread_count worker threads and returns once all
+            attempts are done. worker is the index of the calling worker thread in
+            [0, m_thread_count). Workers claim chunk_size attempts at once.
+         */
+        void run_workers(std::int_fast32_t attempt_count, std::int_fast32_t chunk_size,
+                         std::function<void(int worker, std::int_fast32_t attempt)> const &attempt_fun) const;
+
+        BestGrids generate_with_local_scoring();
+        BestGrids generate_with_central_scoring();
 
-        Grid generate_single_grid();
+        /**
+            Beam search: starts with up to beam_width grids holding one first word
+            each. In every step, each grid is expanded with the beam_expansions
+            valid placements of its unplaced words that cross the most words and
+            grow the grid the least. The resulting grids are scored and the
+            beam_width best distinct ones are kept for the next step, until no grid
+            can be expanded anymore.
+         */
+        BestGrids generate_with_beam_search();
 
     public:
+        /**
+            Constructs a new generator. Generation options are read from the
+            [generation] section of config:
+                threads = number of worker threads, 0 for all cores (Default 0)
+                seed = seed for the random generators (Default current time)
+                mode = restarts | beam (Default restarts)
+                scoring = local | central, restarts mode only (Default local)
+                beam_width = grids kept by beam search (Default 32)
+                beam_expansions = placements tried per grid by beam search (Default 8)
+                best_grid_count = number of best grids returned by generate() (Default 1)
+                disconnected_words = all | largest | fail (Default largest)
+            The placement strategy is read from the [placement] section, see
+            PlacementStrategy::create(...).
+         */
         Generator(std::int_fast32_t number_of_crosswords_to_generated,
                   std::int_fast32_t crossword_max_width, std::int_fast32_t crossword_max_height,
-                  std::unique_ptr<WordProvider> provider, std::unique_ptr<Scorer> grid_scorer);
+                  std::unique_ptr<WordProvider> provider, std::unique_ptr<Scorer> grid_scorer,
+                  INIReader const &config);
 
-        Grid generate();
+        /**
+            Generates crossword_generation_count grids, or searches grids with beam
+            search in beam mode.
+            @return the best_grid_count highest scoring grids, the best grid first.
+         */
+        std::vector<Grid> generate();
     };
 }
\ No newline at end of file
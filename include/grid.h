@@ -1,13 +1,13 @@
 #pragma once
 
 #include <cstdint>
+#include <array>
 #include <utility>
 #include <vector>
 #include <map>
-#include <set>
 #include <memory>
 
-#include "word.h"
+#include "wordstore.h"
 
 namespace Crossword
 {
@@ -27,20 +27,135 @@ namespace Crossword
         bool operator<(Location const &other) const;
     } Location;
 
+    /**
+        Compact placement of a word on a specific grid: the internal index of the
+        cell of the first letter and the direction, packed into 32 bits. Use
+        _Grid::to_location(...) to get the row and column.
+     */
+    typedef struct Placement
+    {
+        // (cell << 1) | direction
+        std::uint32_t packed;
+
+        static Placement make(gidx cell, Direction direction)
+        {
+            return {(static_cast<std::uint32_t>(cell) << 1) | direction};
+        }
+
+        gidx cell() const
+        {
+            return packed >> 1;
+        }
+
+        Direction direction() const
+        {
+            return static_cast<Direction>(packed & 1);
+        }
+
+        // same order as Location, i.e. by row, column, direction
+        bool operator<(Placement const &other) const
+        {
+            return packed < other.packed;
+        }
+
+        bool operator==(Placement const &other) const
+        {
+            return packed == other.packed;
+        }
+    } Placement;
+
+    /**
+        Properties of a valid placement of a word on the current grid, computed
+        while validating it.
+     */
+    typedef struct PlacementFeatures
+    {
+        // number of letters of the word that are already on the grid
+        std::uint16_t crossings;
+        // number of rows and columns the used part of the grid grows by
+        std::uint16_t added_rows;
+        std::uint16_t added_columns;
+    } PlacementFeatures;
+
+    /**
+        Placement of a word crossing a cell of the grid with its letter at 'offset'.
+     */
+    typedef struct CrossingPlacement
+    {
+        wid word;
+        std::uint32_t offset;
+        gidx cell;
+        Placement placement;
+        PlacementFeatures features;
+    } CrossingPlacement;
+
     class _Grid
     {
     private:
         // size of the internal grid
         gidx m_internal_row_count;
         gidx m_internal_column_count;
-        std::unique_ptr<char[]> m_grid;
+        // distance between two rows in m_grid, including the sentinel columns
+        gidx m_grid_stride;
+        std::vector<char> m_grid;
 
         // words placed on the grid
-        std::map<Location, Word> m_words;
+        // all words that can be placed on this grid
+        std::shared_ptr<WordStore const> m_word_store;
+
+        // ids of the words placed on the grid
+        std::map<Placement, wid> m_words;
+
+        // Hash table of the word starting at each placement, for lookups in
+        // constant time. It uses open addressing with linear probing. Its capacity
+        // is a power of two and at least twice the number of placed words, so it
+        // stays small when copying the grid.
+        typedef struct WordStart
+        {
+            Placement placement;
+            // WordStore::NO_WORD for empty slots
+            wid word;
+        } WordStart;
+        static constexpr std::size_t MIN_WORD_START_CAPACITY = 16;
+        std::vector<WordStart> m_word_starts;
+        std::size_t m_word_start_count;
 
-        std::map<char, std::set<gidx>> m_char_loc_lookup;
+        std::size_t get_word_start_slot(Placement placement) const;
+        // id of the word starting at placement or WordStore::NO_WORD
+        wid find_word_start(Placement placement) const;
+        void add_word_start(Placement placement, wid word);
+        void remove_word_start(Placement placement);
+
+        // For every letter, the sorted cells containing it. Indexed by the letter's
+        // byte value. Each filled cell is listed exactly once, even if it is a
+        // crossing.
+        static constexpr std::size_t LETTER_CODE_COUNT = 256;
+        std::array<std::vector<gidx>, LETTER_CODE_COUNT> m_letter_cells;
+        std::int_fast32_t m_placed_letter_count;
+        // letter_mask of all letters on the grid and the number of cells
+        // contributing to each of its bits
+        letter_mask m_placed_letter_mask;
+        std::array<std::int_fast32_t, 32> m_letter_bit_cells;
         std::int_fast32_t m_crossing_count;
 
+        static std::size_t letter_code(char letter)
+        {
+            return static_cast<unsigned char>(letter);
+        }
+
+        // number of placed words using each cell, i.e. 2 for crossings
+        std::vector<std::uint8_t> m_cell_usage;
+
+        // Occupancy bitboards of the grid, one bit per cell. m_row_bits stores
+        // the rows, m_column_bits the columns, so that the cells spanned by a word
+        // and its neighbours are consecutive bits in both directions.
+        std::vector<std::uint64_t> m_row_bits;
+        std::vector<std::uint64_t> m_column_bits;
+        gidx m_row_bits_stride;
+        gidx m_column_bits_stride;
+
+        void set_occupied(gidx cell, bool occupied);
+
         // maximum number of rows/columns that can be used by valid crossword.
         // Note: m_internal_[row/column]_count may be larger to allow for flexibility
         // in adding new words
@@ -53,51 +168,187 @@ namespace Crossword
         gidx m_min_column_used;
         gidx m_max_column_used;
 
+        // Every placement and removal is recorded together with the grid state
+        // that cannot be derived when undoing it.
+        typedef struct UndoEntry
+        {
+            bool placed;
+            Placement placement;
+            wid word;
+            std::int_fast32_t crossing_count;
+            gidx min_row_used;
+            gidx max_row_used;
+            gidx min_column_used;
+            gidx max_column_used;
+        } UndoEntry;
+        // Copies of a grid start with an empty undo log, as checkpoints are only
+        // valid on the grid they were taken on. This keeps snapshots cheap.
+        struct UndoLog : std::vector<UndoEntry>
+        {
+            UndoLog() = default;
+            UndoLog(UndoLog const &) : std::vector<UndoEntry>() {}
+            UndoLog(UndoLog &&) = default;
+            UndoLog &operator=(UndoLog const &)
+            {
+                clear();
+                return *this;
+            }
+            UndoLog &operator=(UndoLog &&) = default;
+        };
+        UndoLog m_undo_log;
+
+        void push_undo_entry(bool placed, Placement placement, wid word);
+        void restore_bounds(UndoEntry const &entry);
+        void recompute_bounds();
+
+        void add_letter_cell(char letter, gidx cell);
+        void remove_letter_cell(char letter, gidx cell);
+
+        // write/erase the letters of a word, updating the cell usage, letter
+        // lookup and crossing count
+        void write_word(WordView const &word, Placement placement);
+        void erase_word(WordView const &word, Placement placement);
+
+        /**
+            Checks if the word 'word' can be placed at location 'loc' without running
+            out-of-bounds and violating the size constraints of the grid. Sets the
+            rows and columns added by the placement in features.
+         */
+        bool is_in_bounds(WordView const &word, Location const &loc, PlacementFeatures &features) const;
+
+        bool is_valid_placement(WordView const &word, Location const &loc, PlacementFeatures &features) const;
+
     public:
+        typedef std::size_t Checkpoint;
+
         static char const EMPTY_CHAR;
 
-        _Grid(gidx max_row_count, gidx max_column_count);
+        /**
+            Constructs an empty grid for words of word_store. The words are
+            referenced by their id in word_store.
+         */
+        _Grid(gidx max_row_count, gidx max_column_count,
+              std::shared_ptr<WordStore const> word_store);
 
         /**
-            Checks if the word 'word' can be placed at location 'loc' without running
-            out-of-bounds and violating the size constraints of the grid.
+            Removes all words from the grid. Only the cells used by the placed words
+            are touched, so resetting is much cheaper than constructing a new grid.
          */
-        bool is_in_bounds(Word const &word, Location const &loc) const;
+        void reset();
+
+        Placement to_placement(Location const &loc) const;
+        Location to_location(Placement placement) const;
 
         /**
             Checks if this word placement is valid. I.e, it is not out-of-bounds
             and does not create a conflict with any adjecent or crossing words
             already placed on the grid.
          */
-        bool is_valid_placement(Word const &word, Location const &loc) const;
+        bool is_valid_placement(wid word, Placement placement) const;
+
+        /**
+            Same as is_valid_placement(word, placement), but also sets the features
+            of a valid placement.
+         */
+        bool is_valid_placement(wid word, Placement placement, PlacementFeatures &features) const;
 
         /**
             Place a word on grid.  Note that no validity our out-of-bounds checks
             are performed! This means that letters of crossing words will be
             overwritten by this placement. Thus, it is important to check the validity
-            of the placement with valid_placement(word, loc). Alternatively, use
-            place_word(word, loc), which includes the validity check.
+            of the placement with valid_placement(word, placement). Alternatively, use
+            place_word(word, placement), which includes the validity check.
 
             @return true if the word was placed successfully, otherwise false.
          */
-        bool place_word_unchecked(Word const &word, Location const &loc);
+        bool place_word_unchecked(wid word, Placement placement);
 
         /**
             Places a word on the grid. Before placement, the validity of the placement
-            is checked with valid_placement(word, loc).
+            is checked with valid_placement(word, placement).
 
             @return true if the word was placed successfully, otherwise false.
          */
-        bool place_word(Word const &word, Location const &loc);
+        bool place_word(wid word, Placement placement);
+
+        /**
+            @return the placement of word used by place_first_word(word, direction).
+         */
+        Placement get_first_word_placement(wid word, Direction direction) const;
 
         /**
             Place this first word in an empty grid.
             @return true if word was successfully placed. False if word could not be
             placed, e.g. because the grid is not empty.
          */
-        bool place_first_word(Word const &word, Direction direction);
+        bool place_first_word(wid word, Direction direction);
 
-        void get_valid_placements(Word const &word, std::vector<Location> &buffer) const;
+        /**
+            Removes the word placed at 'placement' from the grid. Letters shared
+            with crossing words stay on the grid.
+
+            @return true if a word was removed, false if there is no word at 'placement'.
+         */
+        bool remove_word(Placement placement);
+
+        /**
+            Returns a checkpoint of the current grid state. Passing it to
+            rollback(...) undoes all placements and removals done afterwards.
+         */
+        Checkpoint checkpoint() const;
+
+        /**
+            Undoes all placements and removals done after the checkpoint was taken.
+            The checkpoint must have been taken on this grid since its last reset or
+            assignment and must not be newer than checkpoints already rolled back to.
+            Checkpoints of a grid are not valid on its copies.
+         */
+        void rollback(Checkpoint checkpoint);
+
+        /**
+            Appends all valid placements of word that cross at least one word already
+            on the grid to buffer.
+         */
+        void get_valid_placements(wid word, std::vector<Placement> &buffer) const;
+
+        /**
+            Same as get_valid_placements(word, buffer), but also appends the crossing
+            letter and cell of every placement.
+         */
+        void get_valid_placements(wid word, std::vector<CrossingPlacement> &buffer) const;
+
+        /**
+            Calls visit(CrossingPlacement const &) for every valid placement of word
+            that crosses at least one word already on the grid, in the order of
+            get_valid_placements(...), without buffering them. A placement crossing
+            several words is visited once per crossing.
+         */
+        template <typename Visitor>
+        void for_each_valid_placement(wid word, Visitor visit) const;
+
+        /**
+            @return true if word has at least one valid placement crossing a word
+            already on the grid. Stops at the first valid placement found.
+         */
+        bool has_valid_placement(wid word) const;
+
+        /**
+            Appends the cells newly filled by the word at 'placement', i.e. the cells
+            of the word that are not crossings, to buffer. Must be called directly
+            after placing that word. As valid placements of a word can only get fewer
+            by placing other words, only placements crossing these cells may have
+            become valid.
+
+            @return the letter_mask of the letters in the new cells.
+         */
+        letter_mask get_new_cells(Placement placement, std::vector<gidx> &buffer) const;
+
+        /**
+            Appends the valid placements of word crossing the filled cell 'cell' with
+            its letter at 'offset' to buffer. The letter must match the cell.
+         */
+        void get_crossing_placements(wid word, std::uint32_t offset, gidx cell,
+                                     std::vector<CrossingPlacement> &buffer) const;
 
         // Various getter functions
         std::int_fast32_t get_height() const;
@@ -106,7 +357,21 @@ namespace Crossword
         std::int_fast32_t get_placed_word_count() const;
         std::int_fast32_t get_word_crossing_count() const;
         char get_cell_content(gidx row, gidx column) const;
-        Word const *get_word_starting_at(gidx row, gidx column, Direction dir) const;
+        char get_cell_letter(gidx cell) const;
+        letter_mask get_placed_letter_mask() const;
+        WordStore const &get_word_store() const;
+
+        /**
+            @return the id of the word starting at row/column (relative to the used
+            part of the grid) in direction dir or WordStore::NO_WORD if there is none.
+         */
+        wid get_word_starting_at(gidx row, gidx column, Direction dir) const;
+
+        /**
+            @return the ids of all placed words by their placement, ordered by row,
+            column and direction of their first letter.
+         */
+        std::map<Placement, wid> const &get_placed_words() const;
 
         /**
             Prints the current grid on console.
@@ -118,4 +383,32 @@ namespace Crossword
     };
     using Grid = std::shared_ptr<_Grid>;
 
+    template <typename Visitor>
+    void _Grid::for_each_valid_placement(wid id, Visitor visit) const
+    {
+        // cheap prefilter: a word without any letter on the grid cannot cross
+        if ((m_word_store->get_letter_mask(id) & m_placed_letter_mask) == 0)
+            return;
+
+        WordView const word = m_word_store->get_word(id);
+        for (auto cidx = 0; cidx < word.length; cidx++)
+        {
+            std::uint32_t const offset = cidx;
+            for (auto const &cell : m_letter_cells[letter_code(word[cidx])])
+            {
+                gidx const row = cell / m_grid_stride - 1;
+                gidx const col = cell % m_grid_stride - 1;
+                PlacementFeatures features;
+                if (is_valid_placement(word, {row - cidx, col, Direction::VERTICAL}, features))
+                {
+                    visit(CrossingPlacement{id, offset, cell, Placement::make(cell - cidx * m_grid_stride, Direction::VERTICAL), features});
+                }
+                if (is_valid_placement(word, {row, col - cidx, Direction::HORIZONTAL}, features))
+                {
+                    visit(CrossingPlacement{id, offset, cell, Placement::make(cell - cidx, Direction::HORIZONTAL), features});
+                }
+            }
+        }
+    }
+
 } // namespace crossword
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "placementstrategy.h"
+
+namespace Crossword
+{
+    /**
+        Tries the words with the highest heuristic value first, e.g. the longest
+        words.
+
+        With a temperature above 0, the order is randomized-greedy instead: the
+        order is drawn at random, every next word with a probability proportional
+        to exp(value / temperature) among the remaining words. Values are
+        normalized to [0, 1], so a temperature near 0 is greedy and a high
+        temperature approaches a random order.
+     */
+    class HeuristicStrategy : public PlacementStrategy
+    {
+    public:
+        enum class Heuristic
+        {
+            // number of letters
+            LENGTH,
+            // see WordAnalysis::get_crossability(...)
+            CROSSABILITY
+        };
+
+    private:
+        // normalized heuristic value of every word
+        std::vector<double> m_values;
+        double m_temperature;
+
+    public:
+        HeuristicStrategy(Heuristic heuristic, double temperature,
+                          WordStore const &words, WordAnalysis const &analysis,
+                          INIReader const &config);
+
+        void order_words(std::vector<wid> &words, Rng &rng) const override;
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <fstream>
+#include <cstddef>
+#include <string>
+#include <vector>
 
 #include "grid.h"
 
@@ -9,15 +11,42 @@ namespace Crossword
     class LatexGenerator
     {
     private:
-        void add_preamble(std::ofstream &) const;
-        void add_puzzle_macros(std::ofstream &) const;
-        void add_puzzle(Grid const &grid, std::ofstream &) const;
-        void add_hints(Grid const &, std::ofstream &) const;
-        void add_pagebreak(std::ofstream &) const;
-        void add_solutionmode(std::ofstream &) const;
-        void add_closing(std::ofstream &) const;
+        // Documents are rendered into strings and written at once, as many small
+        // writes to a stream are slow.
+        void add_preamble(std::string &) const;
+        void add_puzzle_macros(std::string &) const;
+        void add_puzzle(Grid const &grid, std::string &) const;
+        void add_hints(Grid const &, std::string &) const;
+        void add_pagebreak(std::string &) const;
+        void add_solutionmode(std::string &) const;
+        void add_closing(std::string &) const;
+
+        // puzzle and hints of one grid, rendered independently of other grids
+        typedef struct RenderedPuzzle
+        {
+            std::string puzzle;
+            std::string hints;
+        } RenderedPuzzle;
+
+        RenderedPuzzle render(Grid const &grid) const;
+        void write_document(std::vector<RenderedPuzzle> const &puzzles, std::size_t first,
+                            std::size_t last, std::string const &fileloc) const;
 
     public:
         void generate(Grid const &grid, std::string const &fileloc) const;
+
+        /**
+            Writes all grids into documents with at most puzzles_per_document
+            puzzles each, or into a single document if puzzles_per_document is 0.
+            All puzzles of a document come first, followed by their solutions.
+            With several documents, the number of the document is appended to the
+            file name, e.g. crossword_2.tex. The puzzles are rendered in parallel
+            by thread_count threads, 0 uses all available cores.
+
+            @return the locations of the written documents.
+         */
+        std::vector<std::string> generate(std::vector<Grid> const &grids, std::string const &fileloc,
+                                          std::size_t puzzles_per_document = 0,
+                                          int thread_count = 1) const;
     };
-} // namespace Crossword
\ No newline at end of file
+} // namespace Crossword
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Crossword
+{
+    /**
+        Read-only memory mapping of a whole file. The file content can be accessed
+        without copying it, as long as the MappedFile exists.
+     */
+    class MappedFile
+    {
+    public:
+        /**
+            How the mapped data is going to be read, passed on to the operating
+            system to tune read-ahead.
+         */
+        enum class Access
+        {
+            SEQUENTIAL, // read once from start to end, e.g. text files
+            RANDOM      // read at random positions, e.g. binary word lists
+        };
+
+    private:
+        char const *m_data;
+        std::size_t m_size;
+
+    public:
+        /**
+            Maps the file at location into memory.
+            Throws std::runtime_error if the file cannot be opened or mapped.
+            @param access How the data is going to be read. (Default SEQUENTIAL)
+         */
+        explicit MappedFile(std::string const &location, Access access = Access::SEQUENTIAL);
+        ~MappedFile();
+
+        MappedFile(MappedFile const &) = delete;
+        MappedFile &operator=(MappedFile const &) = delete;
+
+        std::string_view get_data() const
+        {
+            return {m_data, m_size};
+        }
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "wordstore.h"
+#include "wordprovider.h"
+
+namespace Crossword
+{
+  class MergedWordProvider : public WordProvider
+  {
+  public:
+    /**
+       How the clue of a solution is chosen if several sources have different
+       clues for it.
+     */
+    enum class ClueConflict
+    {
+      // keep the clue that was read first
+      FIRST,
+      // keep the clue that was read last
+      LAST,
+      // join all different clues, separated by " / "
+      JOIN,
+      // fail to load the word lists
+      ERROR
+    };
+
+  private:
+    std::vector<std::unique_ptr<WordProvider>> m_sources;
+    ClueConflict m_clue_conflict;
+
+  public:
+    /**
+       Constructs a new crossword word provider that merges the words of several
+       other word providers, keeping every solution only once.
+       @param sources The providers to merge, in the order their words are read.
+       @param clue_conflict How to choose between different clues of a solution.
+     */
+    MergedWordProvider(std::vector<std::unique_ptr<WordProvider>> sources,
+                       ClueConflict clue_conflict = ClueConflict::FIRST);
+
+    /**
+       Parses the name of a clue conflict policy as used in the config file:
+       first, last, join or error.
+       @throws std::runtime_error if name is unknown.
+     */
+    static ClueConflict parse_clue_conflict(std::string const &name);
+
+    /**
+       Retrieves the words of all sources and appends every solution once to
+       words, in the order of its first occurrence. Solutions are compared as
+       stored by the sources, i.e. trimmed and in upper case.
+       @param words The word store to which the retrieved words are appended to.
+     */
+    void retrieve_word_list(WordStore &words) const override;
+  };
+}
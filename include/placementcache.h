@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "grid.h"
+#include "wordstore.h"
+
+namespace Crossword
+{
+    /**
+        Valid placements of all words not yet placed on a grid, maintained
+        incrementally while words are placed.
+
+        The placements of a word are updated lazily when they are requested:
+        cached placements are only validated again if a word was placed near them
+        since (all of them if the used size of the grid changed) and only
+        placements crossing the cells filled since are added. The placements of a
+        word are kept in the same order and multiplicity as returned by
+        _Grid::get_valid_placements(...), i.e. once per crossing.
+     */
+    class PlacementCache
+    {
+    private:
+        // cells spanned by a placed word
+        typedef struct Span
+        {
+            gidx first_row;
+            gidx last_row;
+            gidx first_column;
+            gidx last_column;
+        } Span;
+
+        // cell newly filled by the word placed as number 'placed'
+        typedef struct NewCell
+        {
+            std::size_t placed;
+            gidx cell;
+        } NewCell;
+
+        std::vector<std::vector<CrossingPlacement>> m_placements;
+        // per word: number of placed words when its placements were last updated
+        std::vector<std::size_t> m_updated_placements;
+        // words that got placements since the last reset
+        std::vector<wid> m_touched_words;
+
+        // spans of all placed words in placement order
+        std::vector<Span> m_placed_spans;
+        // letters of the cells newly filled by each placed word
+        std::vector<letter_mask> m_new_letters;
+        // For every letter, the cells newly filled with it in placement order.
+        // Indexed by the letter's byte value.
+        static constexpr std::size_t LETTER_CODE_COUNT = 256;
+        std::array<std::vector<NewCell>, LETTER_CODE_COUNT> m_new_cells_by_letter;
+        std::vector<gidx> m_new_cells;
+
+        // number of placed words when the used size of the grid last changed
+        std::size_t m_size_changed_placements;
+        std::int_fast32_t m_grid_height;
+        std::int_fast32_t m_grid_width;
+
+        void update(_Grid const &grid, wid word);
+
+    public:
+        /**
+            Clears the cache for an empty grid of words of a store with word_count
+            words.
+         */
+        void reset(std::size_t word_count);
+
+        /**
+            Records that word was placed at placement on grid. Must be called
+            directly after every placement, including the first word.
+         */
+        void word_placed(_Grid const &grid, wid word, Placement placement);
+
+        /**
+            @return the valid placements of an unplaced word on grid.
+         */
+        std::vector<CrossingPlacement> const &get_valid_placements(_Grid const &grid, wid word);
+    };
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "grid.h"
+#include "random.h"
+#include "wordanalysis.h"
+#include "wordstore.h"
+
+#include "INIReader.h"
+
+namespace Crossword
+{
+    /**
+        Decides in which order the generator tries to place words and where it
+        places them. Strategies are shared by all worker threads, so their
+        methods must be thread-safe.
+     */
+    class PlacementStrategy
+    {
+    private:
+        bool m_weighted;
+        double m_crossing_factor;
+        double m_growth_factor;
+
+    protected:
+        /**
+            Reads how placements are chosen from the [placement] section of config:
+                choice = uniform | weighted (Default uniform)
+                crossing_factor = weight factor per additional crossing (Default 4)
+                growth_factor = weight factor per added row or column (Default 0.5)
+         */
+        PlacementStrategy(INIReader const &config);
+
+    public:
+        virtual ~PlacementStrategy() = default;
+
+        /**
+            Creates the strategy of type type, reading its options from the
+            [placement] section of config.
+            @return nullptr if there is no strategy of type type.
+         */
+        static std::unique_ptr<PlacementStrategy> create(std::string const &type, INIReader const &config,
+                                                         WordStore const &words, WordAnalysis const &analysis);
+
+        /**
+            Orders words in the order they are tried to be placed in the next
+            round of an attempt, the first word first.
+         */
+        virtual void order_words(std::vector<wid> &words, Rng &rng) const = 0;
+
+        /**
+            Removes the word placed first on an empty grid from words and returns
+            it. By default, this is the first word of order_words(...).
+         */
+        virtual wid take_first_word(std::vector<wid> &words, Rng &rng) const;
+
+        /**
+            Chooses where to place word. With uniform choice, every entry of
+            placements is chosen with the same probability, i.e. a placement
+            crossing k words is k times as likely as one crossing a single word.
+            With weighted choice, a placement is chosen with a probability
+            proportional to crossing_factor^(crossings - 1) *
+            growth_factor^(added rows + added columns).
+            @param placements The valid placements of word, must not be empty.
+         */
+        virtual Placement choose_placement(wid word, std::vector<CrossingPlacement> const &placements,
+                                           Rng &rng) const;
+    };
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace Crossword
+{
+    /**
+        Small and fast pseudo random number generator (xoshiro256**).
+
+        Every generator is derived from a master seed and a stream number, e.g. the
+        index of a generation attempt. Generators of different streams are
+        statistically independent, so work can be distributed over threads in any
+        order while the random numbers used for a given stream stay the same.
+
+        Satisfies UniformRandomBitGenerator, but prefer below(...) and shuffle(...)
+        over the std distributions: their results are implementation defined and
+        would make results differ between standard libraries.
+     */
+    class Rng
+    {
+    private:
+        std::uint64_t m_state[4];
+
+        static std::uint64_t splitmix64(std::uint64_t &x)
+        {
+            std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        static std::uint64_t rotl(std::uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+    public:
+        typedef std::uint64_t result_type;
+
+        Rng(std::uint64_t seed, std::uint64_t stream = 0)
+        {
+            // hash the stream number first, so that neighbouring streams do not
+            // start from neighbouring splitmix states
+            std::uint64_t stream_state = stream;
+            std::uint64_t x = seed ^ splitmix64(stream_state);
+            for (auto &state : m_state)
+            {
+                state = splitmix64(x);
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            std::uint64_t const result = rotl(m_state[1] * 5, 7) * 9;
+            std::uint64_t const t = m_state[1] << 17;
+
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = rotl(m_state[3], 45);
+
+            return result;
+        }
+
+        /**
+            @return a uniformly distributed number in [0, bound). bound must not be 0.
+         */
+        std::uint64_t below(std::uint64_t bound)
+        {
+            // reject the lowest (2^64 mod bound) values to avoid modulo bias
+            std::uint64_t const threshold = (0 - bound) % bound;
+            std::uint64_t r;
+            do
+            {
+                r = (*this)();
+            } while (r < threshold);
+            return r % bound;
+        }
+
+        /**
+            @return a uniformly distributed number in (0, 1), i.e. never exactly 0
+            or 1, so that its logarithm is finite.
+         */
+        double uniform()
+        {
+            // 53 random bits, the precision of a double, centered in their interval
+            return (static_cast<double>((*this)() >> 11) + 0.5) * 0x1.0p-53;
+        }
+
+        /**
+            Fisher-Yates shuffle of [first, last) with a platform independent result.
+         */
+        template <typename RandomIt>
+        void shuffle(RandomIt first, RandomIt last)
+        {
+            auto const count = last - first;
+            for (decltype(last - first) i = count - 1; i > 0; i--)
+            {
+                using std::swap;
+                swap(first[i], first[below(i + 1)]);
+            }
+        }
+    };
+
+    /**
+        Chooses one item of a stream of items at random in a single pass, without
+        buffering the items (weighted reservoir sampling). Every offered item is
+        chosen with a probability proportional to its weight. Weights are either
+        unsigned integers, whose sum must fit into 64 bits, or floating point
+        numbers.
+     */
+    template <typename T, typename Weight = std::uint64_t>
+    class Reservoir
+    {
+    private:
+        Rng &m_rng;
+        Weight m_total_weight;
+        T m_chosen;
+
+    public:
+        explicit Reservoir(Rng &rng) : m_rng(rng), m_total_weight(0), m_chosen() {}
+
+        void offer(T const &item, Weight weight = 1)
+        {
+            if (!(weight > 0))
+                return;
+
+            // keep the new item with probability weight / total weight, which
+            // keeps every earlier item with a probability proportional to its weight
+            m_total_weight += weight;
+            bool keep;
+            if constexpr (std::is_floating_point_v<Weight>)
+                keep = m_rng.uniform() * m_total_weight < weight;
+            else
+                keep = m_rng.below(m_total_weight) < weight;
+            if (keep)
+                m_chosen = item;
+        }
+
+        /**
+            @return true if no item with a weight above 0 was offered.
+         */
+        bool empty() const
+        {
+            return m_total_weight == 0;
+        }
+
+        /**
+            @return the chosen item. Must not be called if empty().
+         */
+        T const &get() const
+        {
+            return m_chosen;
+        }
+    };
+}
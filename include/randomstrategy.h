@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+#include "placementstrategy.h"
+
+namespace Crossword
+{
+    /**
+        Tries the words in random order.
+     */
+    class RandomStrategy : public PlacementStrategy
+    {
+    public:
+        RandomStrategy(INIReader const &config);
+
+        void order_words(std::vector<wid> &words, Rng &rng) const override;
+
+        wid take_first_word(std::vector<wid> &words, Rng &rng) const override;
+    };
+}
@@ -15,6 +15,8 @@ namespace Crossword
     class Scorer
     {
     public:
+        virtual ~Scorer() = default;
+
         static std::unique_ptr<Scorer> create(std::string const &type, INIReader const &config);
 
         virtual score score_grid(Grid const &grid,
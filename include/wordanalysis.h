@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#include "wordstore.h"
+
+namespace Crossword
+{
+    /**
+        Static analysis of which words of a WordStore can ever cross each other,
+        computed once when the words are loaded.
+
+        Two words can only cross if they share a letter, i.e. a byte of their
+        solutions, as the grid stores one byte per cell. Words that are
+        transitively connected by shared letters form a component of the crossing
+        graph. Words of different components can never be part of the same grid,
+        so a grid can hold at most the words of its first word's component.
+        Words longer than the grid can not be placed at all and belong to no
+        component.
+
+        The crossability of a word is the sum of the number of letters it shares
+        with every other word, counting every distinct letter once per word. It
+        is computed from the number of words containing each letter instead of
+        comparing all pairs of words.
+     */
+    class WordAnalysis
+    {
+    private:
+        static constexpr std::size_t LETTER_CODE_COUNT = 256;
+
+        // number of words containing each letter, indexed by its byte value
+        std::array<std::uint32_t, LETTER_CODE_COUNT> m_letter_word_counts;
+        std::vector<std::uint64_t> m_crossabilities;
+        // component of every word, components are numbered by descending size
+        std::vector<std::uint32_t> m_components;
+        std::vector<std::size_t> m_component_sizes;
+        std::int_fast32_t m_max_length;
+        std::size_t m_too_long_count;
+
+    public:
+        static constexpr std::uint32_t NO_COMPONENT = std::numeric_limits<std::uint32_t>::max();
+
+        /**
+            Analyses words for grids that fit words of up to max_length letters.
+         */
+        WordAnalysis(WordStore const &words,
+                     std::int_fast32_t max_length = std::numeric_limits<std::int_fast32_t>::max());
+
+        /**
+            @return the number of words containing letter.
+         */
+        std::uint32_t get_letter_word_count(char letter) const
+        {
+            return m_letter_word_counts[static_cast<unsigned char>(letter)];
+        }
+
+        std::uint64_t get_crossability(wid word) const
+        {
+            return m_crossabilities[word];
+        }
+
+        /**
+            @return the component of word. Component 0 is the largest one.
+            NO_COMPONENT if word is too long to be placed.
+         */
+        std::uint32_t get_component(wid word) const
+        {
+            return m_components[word];
+        }
+
+        std::size_t get_component_count() const
+        {
+            return m_component_sizes.size();
+        }
+
+        std::size_t get_component_size(std::uint32_t component) const
+        {
+            return m_component_sizes[component];
+        }
+
+        /**
+            @return the number of words that are too long to be placed.
+         */
+        std::size_t get_too_long_count() const
+        {
+            return m_too_long_count;
+        }
+
+        /**
+            @return all words of component in ascending order.
+         */
+        std::vector<wid> get_component_words(std::uint32_t component) const;
+
+        /**
+            Prints a summary of the analysis, listing words that can never be
+            placed together with the words of the largest component.
+         */
+        void report(WordStore const &words, std::ostream &out) const;
+    };
+}
@@ -5,33 +5,40 @@
 #include <map>
 #include <functional>
 
-#include "word.h"
+#include "wordstore.h"
+
+#include "INIReader.h"
 
 namespace Crossword
 {
     class WordProvider
     {
     private:
-        static std::map<std::string, std::function<std::unique_ptr<WordProvider>(std::string)>> m_factories;
+        static std::map<std::string, std::function<std::unique_ptr<WordProvider>(std::string, INIReader const &)>> m_factories;
 
     public:
+        virtual ~WordProvider() = default;
+
         /**
-            Convenience function to trim leader/trailing whitespaces
+            Convenience function to trim leader/trailing whitespaces. Strings of
+            whitespaces only are trimmed to an empty string.
          */
         static std::string trim(std::string const &str);
 
         /**
            Retrieves a list of crossword words from an abstract source.
-           @param wordlist The word list to which the retrieved words are appended
+           @param words The word store to which the retrieved words are appended
            to.
          */
-        virtual void retrieve_word_list(WordList &wordlist) const = 0;
+        virtual void retrieve_word_list(WordStore &words) const = 0;
 
         /**
            Creates and returns a WordProvider of type type.
            @param type Provider type to create
            @param location Path were the file is located
+           @param config Configuration of providers that need more settings
          */
-        static std::unique_ptr<WordProvider> create(const std::string &type, const std::string &location);
+        static std::unique_ptr<WordProvider> create(const std::string &type, const std::string &location,
+                                                    INIReader const &config);
     };
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mappedfile.h"
+
+namespace Crossword
+{
+    typedef std::uint32_t wid;
+
+    // One bit per letter, see WordStore::get_letter_bit(...)
+    typedef std::uint32_t letter_mask;
+
+    /**
+        Lightweight view on the solution of a word stored in a WordStore.
+     */
+    typedef struct WordView
+    {
+        char const *letters;
+        std::int_fast32_t length;
+
+        char const &operator[](int index) const
+        {
+            return letters[index];
+        }
+    } WordView;
+
+    /**
+        Storage of all words available for generating crosswords, laid out as
+        structure of arrays: the upper-case solutions of all words are stored back
+        to back in one letter arena, their lengths and letter masks in parallel
+        arrays. Clues are stored the same way in an arena of their own, as they
+        are only needed for the output.
+
+        Words are identified by their id, which is the order in which they were
+        added, starting from 0.
+
+        The arrays are either owned by the store or mapped from a binary word list
+        file, see save_binary(...) and load_binary(...). Mapped arrays are shared
+        with all processes mapping the same file and copied on the first change.
+     */
+    class WordStore
+    {
+    private:
+        // read-only view on an array owned by the store or in a mapped file
+        template <typename T>
+        struct ArrayView
+        {
+            T const *data = nullptr;
+            std::size_t size = 0;
+
+            T const &operator[](std::size_t index) const
+            {
+                return data[index];
+            }
+        };
+
+        std::vector<char> m_letters;
+        // start of each solution in m_letters
+        std::vector<std::uint32_t> m_offsets;
+        std::vector<std::uint16_t> m_lengths;
+        std::vector<letter_mask> m_letter_masks;
+        // clue i is m_clue_letters[m_clue_offsets[i]] to m_clue_letters[m_clue_offsets[i + 1] - 1]
+        std::vector<char> m_clue_letters;
+        std::vector<std::uint64_t> m_clue_offsets;
+
+        // the arrays used by all getters
+        ArrayView<char> m_letters_view;
+        ArrayView<std::uint32_t> m_offsets_view;
+        ArrayView<std::uint16_t> m_lengths_view;
+        ArrayView<letter_mask> m_letter_masks_view;
+        ArrayView<char> m_clue_letters_view;
+        ArrayView<std::uint64_t> m_clue_offsets_view;
+
+        // binary word list file the views point into, if any
+        std::shared_ptr<MappedFile const> m_mapping;
+
+        // point the views to the owned arrays
+        void update_views();
+        // copy mapped arrays into the owned arrays before changing them
+        void make_owned();
+
+    public:
+        static constexpr wid NO_WORD = std::numeric_limits<wid>::max();
+
+        WordStore();
+        WordStore(WordStore const &other);
+        WordStore(WordStore &&other) noexcept;
+        WordStore &operator=(WordStore const &other);
+        WordStore &operator=(WordStore &&other) noexcept;
+
+        /**
+            Returns the bit of letter in a letter_mask. The letters A to Z have bits
+            of their own, all other bytes (e.g. parts of UTF-8 umlauts) share the
+            remaining six bits. Thus, masks of words without common letters never
+            intersect, but masks of words with common letters may intersect.
+         */
+        static letter_mask get_letter_bit(char letter)
+        {
+            unsigned char const code = static_cast<unsigned char>(letter);
+            if (code >= 'A' && code <= 'Z')
+                return letter_mask{1} << (code - 'A');
+            return letter_mask{1} << (26 + code % 6);
+        }
+
+        /**
+            Reserves memory for word_count words with letter_count letters in total.
+         */
+        void reserve(std::size_t word_count, std::size_t letter_count);
+
+        /**
+            Adds a word. The solution is expected to be upper case already.
+            @return The id of the added word.
+         */
+        wid add(std::string_view clue, std::string_view solution);
+
+        std::size_t size() const
+        {
+            return m_lengths_view.size;
+        }
+
+        /**
+            @return the number of letters of all stored solutions.
+         */
+        std::size_t get_letter_count() const
+        {
+            return m_letters_view.size;
+        }
+
+        WordView get_word(wid id) const
+        {
+            return {m_letters_view.data + m_offsets_view[id], m_lengths_view[id]};
+        }
+
+        std::int_fast32_t get_length(wid id) const
+        {
+            return m_lengths_view[id];
+        }
+
+        letter_mask get_letter_mask(wid id) const
+        {
+            return m_letter_masks_view[id];
+        }
+
+        std::string_view get_clue(wid id) const
+        {
+            std::uint64_t const begin = m_clue_offsets_view[id];
+            return {m_clue_letters_view.data + begin, static_cast<std::size_t>(m_clue_offsets_view[id + 1] - begin)};
+        }
+
+        std::string get_solution(wid id) const;
+
+        /**
+            Moves all words of part to the end of this store. Their ids are shifted
+            by the size of this store, so appending parts in order gives the same
+            ids as adding their words in order.
+         */
+        void append(WordStore &&part);
+
+        /**
+            Writes all words to a binary word list file that can be loaded by
+            load_binary(...).
+            Throws std::runtime_error if the file cannot be written.
+         */
+        void save_binary(std::string const &location) const;
+
+        /**
+            Maps a binary word list file written by save_binary(...) into memory and
+            returns a store using the mapped arrays without copying them.
+            Throws std::runtime_error if the file is no valid binary word list of
+            the current format version. The positions of all words and clues are
+            checked to lie within the file, which takes time linear in the number
+            of words.
+         */
+        static WordStore load_binary(std::string const &location);
+    };
+}
@@ -0,0 +1,25 @@
+#include <iostream>
+#include <utility>
+
+#include "binarywordprovider.h"
+
+using namespace Crossword;
+
+BinaryWordProvider::BinaryWordProvider(const std::string &location) : m_location(location)
+{
+    std::cout << "Initialized binary word list provider. "
+              << "Location: " << location << std::endl;
+}
+
+void BinaryWordProvider::retrieve_word_list(WordStore &words) const
+{
+    WordStore mapped_words = WordStore::load_binary(m_location);
+    if (words.size() == 0)
+    {
+        words = std::move(mapped_words);
+    }
+    else
+    {
+        words.append(std::move(mapped_words));
+    }
+}
@@ -1,15 +1,155 @@
 #include <algorithm>
+#include <cctype>
 #include <cstdint>
+#include <exception>
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <string_view>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "csvwordprovider.h"
+#include "mappedfile.h"
 
 using namespace Crossword;
 
+namespace
+{
+    std::string_view trim_spaces(std::string_view str)
+    {
+        std::size_t const first = str.find_first_not_of(' ');
+        if (first == std::string_view::npos)
+            return str.substr(0, 0);
+        std::size_t const last = str.find_last_not_of(' ');
+        return str.substr(first, last - first + 1);
+    }
+
+    /**
+        Parser of CSV records (RFC 4180) working in place on the file data.
+        Fields may be quoted with '"' to contain delimiters, line breaks and
+        quotes, which are escaped by doubling them.
+     */
+    class CSVParser
+    {
+    private:
+        std::string_view m_data;
+        std::size_t m_pos;
+        char m_delim;
+
+    public:
+        CSVParser(std::string_view data, std::size_t pos, char delim) : m_data(data), m_pos(pos), m_delim(delim) {}
+
+        bool at_end() const
+        {
+            return m_pos >= m_data.size();
+        }
+
+        std::size_t get_position() const
+        {
+            return m_pos;
+        }
+
+        bool at_delimiter() const
+        {
+            return !at_end() && m_data[m_pos] == m_delim;
+        }
+
+        /**
+            Consumes the line break ending a record, if any.
+            @return false if the current field is not followed by a line break or
+            the end of the data.
+         */
+        bool end_record()
+        {
+            if (at_end())
+                return true;
+            if (m_data[m_pos] == '\r' && m_pos + 1 < m_data.size() && m_data[m_pos + 1] == '\n')
+                m_pos++;
+            if (m_data[m_pos] != '\n')
+                return false;
+            m_pos++;
+            return true;
+        }
+
+        void skip_delimiter()
+        {
+            m_pos++;
+        }
+
+        /**
+            @return the physical line containing position pos, for error messages.
+         */
+        std::string get_line(std::size_t pos) const
+        {
+            std::size_t end = m_data.find('\n', pos);
+            if (end == std::string_view::npos)
+                end = m_data.size();
+            return std::string(m_data.substr(pos, end - pos));
+        }
+
+        /**
+            Parses the next field. Unquoted fields are trimmed. The returned view
+            points into the data, unless the field contains escaped quotes. Then,
+            it points into buffer.
+            @return false if a quoted field is not closed or followed by garbage.
+         */
+        bool parse_field(std::string &buffer, std::string_view &field)
+        {
+            std::size_t const begin = m_pos;
+            while (!at_end() && m_data[m_pos] == ' ')
+                m_pos++;
+
+            if (at_end() || m_data[m_pos] != '"')
+            {
+                m_pos = begin;
+                while (!at_end() && m_data[m_pos] != m_delim && m_data[m_pos] != '\n')
+                    m_pos++;
+                std::string_view value = m_data.substr(begin, m_pos - begin);
+                // line break might be \r\n
+                if (!value.empty() && value.back() == '\r' && (at_end() || m_data[m_pos] == '\n'))
+                    value.remove_suffix(1);
+                field = trim_spaces(value);
+                return true;
+            }
+
+            m_pos++;
+            bool escaped = false;
+            while (true)
+            {
+                std::size_t const quote = m_data.find('"', m_pos);
+                if (quote == std::string_view::npos)
+                    return false;
+
+                std::string_view const part = m_data.substr(m_pos, quote - m_pos);
+                bool const doubled = quote + 1 < m_data.size() && m_data[quote + 1] == '"';
+                if (!escaped && !doubled)
+                {
+                    field = part;
+                    m_pos = quote + 1;
+                    break;
+                }
+                if (!escaped)
+                    buffer.clear();
+                escaped = true;
+                buffer += part;
+                if (!doubled)
+                {
+                    field = buffer;
+                    m_pos = quote + 1;
+                    break;
+                }
+                buffer += '"';
+                m_pos = quote + 2;
+            }
+
+            while (!at_end() && m_data[m_pos] == ' ')
+                m_pos++;
+            return at_end() || m_data[m_pos] == m_delim || m_data[m_pos] == '\n' || m_data[m_pos] == '\r';
+        }
+    };
+}
+
 CSVWordProvider::CSVWordProvider(const std::string &csv_location,
                                  bool ignore_header, char delim) : m_csv_location(csv_location), m_ignore_header(ignore_header), m_delim(delim)
 {
@@ -17,65 +157,156 @@ CSVWordProvider::CSVWordProvider(const std::string &csv_location,
               << "CSV location: " << csv_location << std::endl;
 }
 
-void CSVWordProvider::retrieve_word_list(WordList &words) const
+std::size_t CSVWordProvider::parse_records(std::string_view data, std::size_t begin, std::size_t end,
+                                           WordStore &words) const
 {
-    // WordList words may have already some entries. Thus, get the highest
-    // existing id in it first.
-    wid next_id = 0;
-    for (auto const &word : words)
-    {
-        next_id = std::max(next_id, word.id);
-    }
-    next_id++;
+    // one word per line at most and less letters than bytes in the chunk
+    std::size_t const line_count = std::count(data.begin() + begin, data.begin() + end, '\n') + 1;
+    words.reserve(words.size() + line_count, words.get_letter_count() + (end - begin));
 
-    std::ifstream csv_file(m_csv_location);
-    if (!csv_file.is_open())
+    CSVParser parser(data, begin, m_delim);
+    std::string clue_buffer;
+    std::string word_buffer;
+    std::string solution;
+    while (!parser.at_end() && parser.get_position() < end)
     {
-        throw std::runtime_error(
-            "Could not open the CSV file! Does it exist?\n"
-            "(Filename: " +
-            m_csv_location + ")");
-    }
-
-    std::string line;
-    if (m_ignore_header)
-    {
-        std::getline(csv_file, line);
-    }
-
-    while (std::getline(csv_file, line))
-    {
-        std::stringstream tokens(line);
-
-        std::string clue;
-        std::string word;
-        getline(tokens, clue, m_delim);
-        getline(tokens, word, m_delim);
-        // make all characters upper case
-        clue = trim(clue);
-        word = trim(word);
-        std::for_each(word.begin(), word.end(), [](char &c)
-                      { c = toupper(c); });
+        std::size_t const line_begin = parser.get_position();
+        std::string_view clue;
+        std::string_view word;
+        if (!parser.parse_field(clue_buffer, clue) ||
+            (parser.at_delimiter() && (parser.skip_delimiter(), !parser.parse_field(word_buffer, word))))
+        {
+            throw std::runtime_error(
+                "Invalid CSV line format! \n"
+                "Quoted field is not closed or followed by other characters \n"
+                "The offending line: " +
+                parser.get_line(line_begin));
+        }
 
-        Word new_word(next_id++, clue, word);
-        if (new_word.clue.empty() || new_word.word.empty())
+        if (clue.empty() || word.empty())
         {
             throw std::runtime_error(
                 "Invalid CSV line format! \n"
                 "Clue or solution word is empty \n"
                 "The offending line: " +
-                line);
+                parser.get_line(line_begin));
         }
 
-        words.push_back(new_word);
-        if (!tokens.eof())
+        if (!parser.end_record())
         {
             throw std::runtime_error(
                 "Invalid CSV line format! \n"
                 "Expected two columns separated by '" +
                 std::string(1, m_delim) + "' but got more.\n"
                                           "The offending line: " +
-                line);
+                parser.get_line(line_begin));
         }
+
+        // make all characters upper case
+        solution.assign(word);
+        std::for_each(solution.begin(), solution.end(), [](char &c)
+                      { c = std::toupper(static_cast<unsigned char>(c)); });
+        words.add(clue, solution);
+    }
+    return parser.get_position();
+}
+
+void CSVWordProvider::retrieve_word_list(WordStore &words) const
+{
+    retrieve_word_list(words, 0);
+}
+
+void CSVWordProvider::retrieve_word_list(WordStore &words, std::size_t chunk_count) const
+{
+    MappedFile const csv_file(m_csv_location);
+    std::string_view const data = csv_file.get_data();
+
+    std::size_t begin = 0;
+    if (m_ignore_header)
+    {
+        std::size_t const header_end = data.find('\n');
+        begin = header_end == std::string_view::npos ? data.size() : header_end + 1;
+    }
+
+    if (chunk_count == 0)
+    {
+        std::size_t const max_chunk_count = std::max(1u, std::thread::hardware_concurrency());
+        chunk_count = std::clamp<std::size_t>((data.size() - begin) / MIN_CHUNK_SIZE, 1, max_chunk_count);
+    }
+    if (chunk_count == 1)
+    {
+        parse_records(data, begin, data.size(), words);
+        return;
+    }
+
+    // split at line breaks, chunk i covers the records starting in [bounds[i], bounds[i + 1])
+    std::vector<std::size_t> bounds(chunk_count + 1);
+    bounds[0] = begin;
+    bounds[chunk_count] = data.size();
+    for (std::size_t i = 1; i < chunk_count; i++)
+    {
+        std::size_t const line_break = data.find('\n', begin + i * (data.size() - begin) / chunk_count);
+        bounds[i] = std::max(bounds[i - 1], line_break == std::string_view::npos ? data.size() : line_break + 1);
     }
-}
\ No newline at end of file
+
+    // every chunk is parsed into a word store of its own
+    typedef struct Chunk
+    {
+        WordStore words;
+        std::size_t end;
+        std::exception_ptr error;
+    } Chunk;
+    std::vector<Chunk> chunks(chunk_count);
+    auto parse_chunk = [&](std::size_t i)
+    {
+        try
+        {
+            chunks[i].end = parse_records(data, bounds[i], bounds[i + 1], chunks[i].words);
+        }
+        catch (...)
+        {
+            chunks[i].error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> parser_threads;
+    for (std::size_t i = 1; i < chunk_count; i++)
+    {
+        parser_threads.push_back(std::thread(parse_chunk, i));
+    }
+    parse_chunk(0);
+    for (auto &thread : parser_threads)
+    {
+        thread.join();
+    }
+
+    // Append the chunks in order, so ids are assigned as if parsed sequentially.
+    // A quoted field may contain a line break a chunk was split at. Then, the
+    // previous chunk ends behind the split and the chunk is parsed again from
+    // the end of the previous one. Errors are reported for the first chunk in
+    // order, i.e. for the first offending line.
+    std::size_t word_count = words.size();
+    std::size_t letter_count = words.get_letter_count();
+    for (Chunk const &chunk : chunks)
+    {
+        word_count += chunk.words.size();
+        letter_count += chunk.words.get_letter_count();
+    }
+    words.reserve(word_count, letter_count);
+
+    std::size_t record_begin = begin;
+    for (std::size_t i = 0; i < chunk_count; i++)
+    {
+        Chunk &chunk = chunks[i];
+        if (bounds[i] != record_begin)
+        {
+            chunk.words = WordStore();
+            chunk.end = parse_records(data, record_begin, std::max(record_begin, bounds[i + 1]), chunk.words);
+        }
+        else if (chunk.error)
+        {
+            std::rethrow_exception(chunk.error);
+        }
+        record_begin = chunk.end;
+        words.append(std::move(chunk.words));
+    }
+}
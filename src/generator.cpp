@@ -1,121 +1,400 @@
 #include <algorithm>
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <unordered_set>
 
 #include "generator.h"
 #include "latexgenerator.h"
+#include "wordanalysis.h"
 
 #include "INIReader.h"
 
-#define SEED_RNG (time(NULL)) // seed is current time in seconds
+#define SEED_RNG (time(NULL)) // default seed is current time in seconds
 
 #define CONFIG_FILE "config.ini"
 
 using namespace Crossword;
 
+namespace
+{
+    /**
+        Escalating wait strategy for threads blocked on the grid buffer: yield the
+        core for the first few rounds, then sleep with exponentially growing
+        intervals so that a blocked thread does not burn a core.
+     */
+    class Backoff
+    {
+    private:
+        constexpr static int YIELD_ROUNDS = 16;
+        constexpr static int MAX_SLEEP_US = 1000;
+
+        int m_round = 0;
+        int m_sleep_us = 1;
+
+    public:
+        void pause()
+        {
+            if (m_round < YIELD_ROUNDS)
+            {
+                m_round++;
+                std::this_thread::yield();
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(m_sleep_us));
+            m_sleep_us = std::min(m_sleep_us * 2, MAX_SLEEP_US);
+        }
+    };
+
+    /**
+        Hash of a placed word. The keys of all words placed on a grid are combined
+        by xor, so that grids with the same words at the same placements have the
+        same key, no matter in which order the words were placed.
+     */
+    std::uint64_t placement_key(wid word, Placement placement)
+    {
+        // splitmix64 finalizer
+        std::uint64_t x = (std::uint64_t{word} << 32) | placement.packed;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // beam search expands grids with the placements crossing the most words and
+    // growing the grid the least first
+    bool better_expansion(CrossingPlacement const &a, CrossingPlacement const &b)
+    {
+        if (a.features.crossings != b.features.crossings)
+            return a.features.crossings > b.features.crossings;
+        int const a_growth = a.features.added_rows + a.features.added_columns;
+        int const b_growth = b.features.added_rows + b.features.added_columns;
+        if (a_growth != b_growth)
+            return a_growth < b_growth;
+        if (a.word != b.word)
+            return a.word < b.word;
+        return a.placement < b.placement;
+    }
+}
+
 Generator::Generator(std::int_fast32_t number_of_crosswords_to_generate,
                      std::int_fast32_t crossword_max_width,
                      std::int_fast32_t crossword_max_height,
                      std::unique_ptr<WordProvider> provider,
-                     std::unique_ptr<Scorer> grid_scorer)
-    : m_rng(std::default_random_engine{}),
-      m_gen_count(number_of_crosswords_to_generate),
+                     std::unique_ptr<Scorer> grid_scorer,
+                     INIReader const &config)
+    : m_gen_count(number_of_crosswords_to_generate),
       m_cw_max_width(crossword_max_width),
       m_cw_max_height(crossword_max_height),
       m_grid_scorer(std::move(grid_scorer))
 {
-    auto rng_seed = SEED_RNG;
-    m_rng.seed(rng_seed);
-    provider->retrieve_word_list(word_list);
+    std::string const mode = config.Get("generation", "mode", "restarts");
+    if (mode == "restarts")
+    {
+        m_mode = GenerationMode::RESTARTS;
+    }
+    else if (mode == "beam")
+    {
+        m_mode = GenerationMode::BEAM;
+    }
+    else
+    {
+        throw std::runtime_error("Unknown generation mode '" + mode +
+                                 "'! Expected 'restarts' or 'beam'.");
+    }
+    long const beam_width = config.GetInteger("generation", "beam_width", 32);
+    long const beam_expansions = config.GetInteger("generation", "beam_expansions", 8);
+    if (beam_width < 1 || beam_expansions < 1)
+    {
+        throw std::runtime_error("beam_width and beam_expansions must be at least 1!");
+    }
+    m_beam_width = beam_width;
+    m_beam_expansions = beam_expansions;
+
+    std::string const scoring_mode = config.Get("generation", "scoring", "local");
+    if (scoring_mode == "local")
+    {
+        m_scoring_mode = ScoringMode::LOCAL;
+    }
+    else if (scoring_mode == "central")
+    {
+        m_scoring_mode = ScoringMode::CENTRAL;
+    }
+    else
+    {
+        throw std::runtime_error("Unknown scoring mode '" + scoring_mode +
+                                 "'! Expected 'local' or 'central'.");
+    }
+    long const best_grid_count = config.GetInteger("generation", "best_grid_count", 1);
+    if (best_grid_count < 1)
+    {
+        throw std::runtime_error("best_grid_count must be at least 1!");
+    }
+    m_best_grid_count = best_grid_count;
+
+    long const thread_count = config.GetInteger("generation", "threads", 0);
+    if (thread_count < 0)
+    {
+        throw std::runtime_error("threads must not be negative!");
+    }
+    // 0 means use all available cores. hardware_concurrency() may return 0 if
+    // it cannot determine the number of cores.
+    m_thread_count = thread_count > 0 ? thread_count
+                                      : std::max(1u, std::thread::hardware_concurrency());
+
+    // GetInteger only supports long, thus read the seed as string to support
+    // the full 64 bit range
+    std::string const seed = config.Get("generation", "seed", "");
+    if (seed.empty())
+    {
+        m_seed = SEED_RNG;
+    }
+    else
+    {
+        try
+        {
+            m_seed = std::stoull(seed, nullptr, 0);
+        }
+        catch (std::logic_error const &)
+        {
+            throw std::runtime_error("Invalid seed '" + seed + "'! Expected a non-negative integer.");
+        }
+    }
+    DisconnectedWords disconnected_words;
+    std::string const disconnected = config.Get("generation", "disconnected_words", "largest");
+    if (disconnected == "all")
+    {
+        disconnected_words = DisconnectedWords::ALL;
+    }
+    else if (disconnected == "largest")
+    {
+        disconnected_words = DisconnectedWords::LARGEST_COMPONENT;
+    }
+    else if (disconnected == "fail")
+    {
+        disconnected_words = DisconnectedWords::FAIL;
+    }
+    else
+    {
+        throw std::runtime_error("Unknown disconnected_words policy '" + disconnected +
+                                 "'! Expected 'all', 'largest' or 'fail'.");
+    }
+
+    auto word_store = std::make_shared<WordStore>();
+    provider->retrieve_word_list(*word_store);
+    m_word_store = std::move(word_store);
+    if (m_word_store->size() == 0)
+    {
+        throw std::runtime_error("The word list is empty!");
+    }
+
+    // Words of other components than the first word can never be placed, so
+    // attempts only need to try the words of one component. Words longer than
+    // the grid can never be placed at all.
+    WordAnalysis const analysis(*m_word_store, std::max(m_cw_max_width, m_cw_max_height));
+    analysis.report(*m_word_store, std::cout);
+    bool const all_placeable = analysis.get_component_count() == 1 && analysis.get_too_long_count() == 0;
+    if (!all_placeable && disconnected_words == DisconnectedWords::FAIL)
+    {
+        throw std::runtime_error("Not all words can be placed in the same grid! Remove the words "
+                                 "listed above or set disconnected_words to 'largest'.");
+    }
+    if (!all_placeable && disconnected_words == DisconnectedWords::LARGEST_COMPONENT)
+    {
+        if (analysis.get_component_count() == 0)
+        {
+            throw std::runtime_error("No word fits into the grid!");
+        }
+        m_candidate_words = analysis.get_component_words(0);
+    }
+    else
+    {
+        m_candidate_words.resize(m_word_store->size());
+        std::iota(m_candidate_words.begin(), m_candidate_words.end(), 0);
+    }
+
+    std::string const placement_type = config.Get("placement", "type", "random");
+    m_placement_strategy = PlacementStrategy::create(placement_type, config, *m_word_store, analysis);
+    if (m_placement_strategy == nullptr)
+    {
+        throw std::runtime_error("Unknown placement strategy '" + placement_type +
+                                 "'! Expected 'random', 'longest', 'crossable' or 'greedy'.");
+    }
     std::cout << "Initialized crossword generator. " << std::endl;
-    std::cout << "Random generator seed is: " << rng_seed << std::endl;
+    if (m_mode == GenerationMode::RESTARTS)
+    {
+        // beam search always scores centrally
+        std::cout << "Scoring mode is: " << scoring_mode << std::endl;
+    }
+    std::cout << "Random generator seed is: " << m_seed << std::endl;
 }
 
-Grid Generator::generate_single_grid()
+void Generator::generate_single_grid(Rng &rng, Workspace &workspace) const
 {
-    std::uniform_int_distribution<int> dist(
-        0, 1); // for generating random vert/horizontal
-    auto grid = std::make_shared<_Grid>(m_cw_max_height, m_cw_max_width);
-    WordList unused_words(word_list);
+    _Grid &grid = *workspace.grid;
+    PlacementCache &placement_cache = workspace.placement_cache;
+    std::vector<wid> &unused_words = workspace.unused_words;
+    std::vector<wid> &unplaced_words = workspace.unplaced_words;
+
+    grid.reset();
+    placement_cache.reset(m_word_store->size());
+    unused_words.assign(m_candidate_words.begin(), m_candidate_words.end());
 
-    // place random first word
-    std::shuffle(std::begin(unused_words), std::end(unused_words), m_rng);
-    Word const first_word = unused_words.back();
-    Direction const first_dir = static_cast<Direction>(dist(m_rng));
+    wid const first_word = m_placement_strategy->take_first_word(unused_words, rng);
+    Direction const first_dir = static_cast<Direction>(rng.below(2));
 
-    grid->place_first_word(first_word, first_dir);
-    unused_words.pop_back();
+    if (!grid.place_first_word(first_word, first_dir))
+        return; // the first word does not fit into the grid
+    placement_cache.word_placed(grid, first_word, grid.get_first_word_placement(first_word, first_dir));
 
-    // in every iteration, shuffle not yet placed words and try to add them at
-    // random valid location in shuffle order. Repeat until no words are left
-    // or no remaining word can be placed.
+    // in every iteration, order the not yet placed words and try to add them in
+    // that order at a location chosen by the placement strategy. Repeat until no
+    // words are left or no remaining word can be placed.
     while (unused_words.size() != 0)
     {
         bool word_placed = false;
-        std::shuffle(std::begin(unused_words), std::end(unused_words), m_rng);
+        m_placement_strategy->order_words(unused_words, rng);
 
-        WordList unplaced_words;
-        for (auto const &word : unused_words)
+        unplaced_words.clear();
+        for (auto const word : unused_words)
         {
-            std::vector<Location> valid_placements;
-            grid->get_valid_placements(word, valid_placements);
+            auto const &valid_placements = placement_cache.get_valid_placements(grid, word);
             if (valid_placements.size() == 0)
             {
                 unplaced_words.push_back(word);
             }
             else
             {
-                std::uniform_int_distribution<int> rng(0, valid_placements.size() - 1);
-                Location rand_loc = valid_placements[rng(m_rng)];
-                grid->place_word_unchecked(word, rand_loc);
+                Placement const placement = m_placement_strategy->choose_placement(word, valid_placements, rng);
+                grid.place_word_unchecked(word, placement);
+                placement_cache.word_placed(grid, word, placement);
                 word_placed = true;
             }
         }
-        unused_words = std::move(unplaced_words);
+        std::swap(unused_words, unplaced_words);
 
         if (!word_placed)
             break;
     }
-
-    return grid;
 }
 
-Grid Generator::generate()
+score Generator::score_grid(Grid const &grid) const
 {
-    int const worker_thread_count = 5;
-    int const grids_per_thread = m_gen_count / worker_thread_count;
-    int const total_grids = grids_per_thread * worker_thread_count;
-
-    auto gridBuffer = std::make_shared<SharedGridBuffer>(worker_thread_count);
+    std::int_fast32_t unplaced_words = m_word_store->size() - grid->get_placed_word_count();
+    return m_grid_scorer->score_grid(grid, unplaced_words);
+}
 
-    std::cout << "Generating " << total_grids << " grids on " << worker_thread_count << " threads and choosing the best"
-              << std::endl;
-    auto begin = std::chrono::high_resolution_clock::now();
+void Generator::run_workers(std::int_fast32_t attempt_count, std::int_fast32_t chunk_size,
+                            std::function<void(int worker, std::int_fast32_t attempt)> const &attempt_fun) const
+{
+    std::atomic<std::int_fast32_t> next_attempt(0);
 
-    auto worker_fun = [this, &grids_per_thread, &gridBuffer](int threadId)
+    // Workers claim chunks of attempts from a shared counter until all attempts
+    // are taken. That way, threads that happen to get fast attempts simply
+    // claim more chunks instead of idling while the others finish.
+    auto worker_fun = [attempt_count, chunk_size, &next_attempt, &attempt_fun](int worker)
     {
-        int gen_count = 0;
-        while (gen_count < grids_per_thread)
+        while (true)
         {
-            gridBuffer->addNextGrid(threadId, generate_single_grid());
-            gen_count++;
+            std::int_fast32_t const chunk_begin =
+                next_attempt.fetch_add(chunk_size, std::memory_order_relaxed);
+            if (chunk_begin >= attempt_count)
+                break;
+
+            std::int_fast32_t const chunk_end =
+                std::min(chunk_begin + chunk_size, attempt_count);
+            for (auto attempt = chunk_begin; attempt < chunk_end; attempt++)
+            {
+                attempt_fun(worker, attempt);
+            }
         }
     };
 
-    Grid best_grid = nullptr;
-    score highest_grid_score = 0;
-    auto process_fun = [this, &total_grids, &best_grid, &highest_grid_score, &gridBuffer]()
+    std::vector<std::thread> generator_threads;
+    for (int i = 0; i < m_thread_count; i++)
+    {
+        generator_threads.push_back(std::thread(worker_fun, i));
+    }
+    for (auto &thread : generator_threads)
+    {
+        thread.join();
+    }
+}
+
+BestGrids Generator::generate_with_local_scoring()
+{
+    std::atomic<std::int_fast32_t> generated_grids(0);
+    std::atomic<score> highest_grid_score(std::numeric_limits<score>::min());
+    std::vector<BestGrids> best_by_thread(m_thread_count, BestGrids(m_best_grid_count));
+    // Every worker generates all its grids on the same grid. Only grids that are
+    // kept as one of the best grids are copied.
+    std::vector<Workspace> workspace_by_thread(m_thread_count);
+
+    run_workers(m_gen_count, ATTEMPTS_PER_CHUNK,
+                [this, &best_by_thread, &workspace_by_thread, &generated_grids, &highest_grid_score](int worker, std::int_fast32_t attempt)
+                {
+                    Workspace &workspace = workspace_by_thread[worker];
+                    if (!workspace.grid)
+                        workspace.grid = std::make_shared<_Grid>(m_cw_max_height, m_cw_max_width, m_word_store);
+                    Grid const &grid = workspace.grid;
+
+                    Rng rng(m_seed, attempt);
+                    generate_single_grid(rng, workspace);
+                    score const grid_score = score_grid(grid);
+                    if (best_by_thread[worker].accepts(grid_score, attempt))
+                    {
+                        best_by_thread[worker].offer(grid_score, attempt, std::make_shared<_Grid>(*grid));
+
+                        // only used for progress output
+                        score current = highest_grid_score.load(std::memory_order_relaxed);
+                        while (grid_score > current &&
+                               !highest_grid_score.compare_exchange_weak(current, grid_score,
+                                                                         std::memory_order_relaxed))
+                        {
+                        }
+                    }
+
+                    auto const generated = generated_grids.fetch_add(1, std::memory_order_relaxed) + 1;
+                    if (generated % PRINT_PROGRESS_EVERY_GRIDS == 0)
+                    {
+                        std::ostringstream os;
+                        os << "Generated " << generated << " out of " << m_gen_count << " grids. "
+                           << "The current best grid has a score of "
+                           << highest_grid_score.load(std::memory_order_relaxed) << "." << std::endl;
+                        std::cout << os.str();
+                    }
+                });
+
+    BestGrids best(m_best_grid_count);
+    for (auto const &thread_best : best_by_thread)
     {
-        int processed_grids = 0;
-        while (processed_grids < total_grids)
+        best.merge(thread_best);
+    }
+    return best;
+}
+
+BestGrids Generator::generate_with_central_scoring()
+{
+    auto gridBuffer = std::make_shared<SharedGridBuffer>();
+
+    BestGrids best(m_best_grid_count);
+    auto process_fun = [this, &best, &gridBuffer]()
+    {
+        Grid best_grid = nullptr;
+        score highest_grid_score = 0;
+        std::int_fast32_t processed_grids = 0;
+        while (processed_grids < m_gen_count)
         {
-            Grid next_grid = gridBuffer->getNextGridToProcess();
-            std::int_fast32_t unplaced_words =
-                word_list.size() - next_grid->get_placed_word_count();
-            score grid_score = m_grid_scorer->score_grid(next_grid, unplaced_words);
+            std::int_fast32_t attempt;
+            Grid next_grid = gridBuffer->getNextGridToProcess(attempt);
+            score grid_score = score_grid(next_grid);
+            best.offer(grid_score, attempt, next_grid);
             if (!best_grid || grid_score > highest_grid_score)
             {
                 highest_grid_score = grid_score;
@@ -134,78 +413,389 @@ Grid Generator::generate()
         }
     };
 
-    std::vector<std::thread> generator_threads;
-    for (int i = 0; i < worker_thread_count; i++)
+    std::thread grid_processor(process_fun);
+    std::vector<Workspace> workspace_by_thread(m_thread_count);
+    run_workers(m_gen_count, ATTEMPTS_PER_CHUNK,
+                [this, &gridBuffer, &workspace_by_thread](int worker, std::int_fast32_t attempt)
+                {
+                    // the grid is handed over to the processing thread, thus it
+                    // cannot be reused for the next attempt
+                    Workspace &workspace = workspace_by_thread[worker];
+                    workspace.grid = std::make_shared<_Grid>(m_cw_max_height, m_cw_max_width, m_word_store);
+                    Rng rng(m_seed, attempt);
+                    generate_single_grid(rng, workspace);
+                    gridBuffer->addNextGrid(attempt, workspace.grid);
+                });
+    grid_processor.join();
+
+    gridBuffer->clear();
+
+    return best;
+}
+
+BestGrids Generator::generate_with_beam_search()
+{
+    typedef struct BeamState
     {
-        generator_threads.push_back(std::thread(worker_fun, i));
+        Grid grid;
+        // xor of the placement_key(...) of all placed words
+        std::uint64_t key;
+    } BeamState;
+
+    typedef struct Expansion
+    {
+        std::size_t state;
+        wid word;
+        Placement placement;
+        score grid_score;
+        // score if all words that can still be placed were placed
+        score potential_score;
+        std::uint64_t key;
+    } Expansion;
+
+    typedef struct BeamWorkspace
+    {
+        Grid grid;
+        std::vector<char> placed;
+        std::vector<CrossingPlacement> placements;
+        std::vector<CrossingPlacement> other_placements;
+        std::vector<CrossingPlacement> expansions;
+    } BeamWorkspace;
+
+    BestGrids best(m_best_grid_count);
+    // order in which grids are offered, breaks ties between equally scored grids
+    std::int_fast32_t offered_grids = 0;
+
+    // start with the first words the placement strategy chooses for the first
+    // beam_width attempts
+    std::vector<BeamState> beam;
+    std::unordered_set<std::uint64_t> keys;
+    std::vector<wid> words;
+    for (std::size_t attempt = 0; attempt < m_beam_width; attempt++)
+    {
+        Rng rng(m_seed, attempt);
+        words.assign(m_candidate_words.begin(), m_candidate_words.end());
+        wid const first_word = m_placement_strategy->take_first_word(words, rng);
+        Direction const first_dir = static_cast<Direction>(rng.below(2));
+
+        auto grid = std::make_shared<_Grid>(m_cw_max_height, m_cw_max_width, m_word_store);
+        if (!grid->place_first_word(first_word, first_dir))
+            continue;
+        std::uint64_t const key = placement_key(first_word, grid->get_first_word_placement(first_word, first_dir));
+        if (!keys.insert(key).second)
+            continue;
+        best.offer(score_grid(grid), offered_grids++, grid);
+        beam.push_back({grid, key});
     }
-    std::thread grid_processor(process_fun);
 
-    for (int i = 0; i < worker_thread_count; i++)
+    std::vector<BeamWorkspace> workspace_by_thread(m_thread_count);
+    std::vector<std::vector<Expansion>> expansions_by_state;
+    std::vector<Expansion> expansions;
+    for (std::size_t placed_words = 1; !beam.empty(); placed_words++)
     {
-        generator_threads[i].join();
+        // expand every grid on a copy, trying each expansion and rolling it back
+        expansions_by_state.assign(beam.size(), {});
+        run_workers(beam.size(), 1,
+                    [this, &beam, &workspace_by_thread, &expansions_by_state](int worker, std::int_fast32_t state)
+                    {
+                        BeamWorkspace &workspace = workspace_by_thread[worker];
+                        if (!workspace.grid)
+                        {
+                            workspace.grid = std::make_shared<_Grid>(*beam[state].grid);
+                            workspace.placed.assign(m_word_store->size(), 0);
+                        }
+                        else
+                        {
+                            *workspace.grid = *beam[state].grid;
+                        }
+                        _Grid &grid = *workspace.grid;
+
+                        for (auto const &[placement, word] : grid.get_placed_words())
+                        {
+                            workspace.placed[word] = 1;
+                        }
+                        workspace.placements.clear();
+                        for (wid const word : m_candidate_words)
+                        {
+                            if (!workspace.placed[word])
+                                grid.get_valid_placements(word, workspace.placements);
+                        }
+                        for (auto const &[placement, word] : grid.get_placed_words())
+                        {
+                            workspace.placed[word] = 0;
+                        }
+
+                        // placements crossing several words are listed once per crossing
+                        std::sort(workspace.placements.begin(), workspace.placements.end(), better_expansion);
+                        workspace.placements.erase(std::unique(workspace.placements.begin(), workspace.placements.end(),
+                                                               [](CrossingPlacement const &a, CrossingPlacement const &b)
+                                                               { return a.word == b.word && a.placement == b.placement; }),
+                                                   workspace.placements.end());
+
+                        // try the best placement of as many different words as possible
+                        // first, so that no word is blocked by expanding only a few of them
+                        workspace.expansions.clear();
+                        workspace.other_placements.clear();
+                        for (CrossingPlacement const &crossing : workspace.placements)
+                        {
+                            if (workspace.placed[crossing.word])
+                            {
+                                workspace.other_placements.push_back(crossing);
+                                continue;
+                            }
+                            workspace.placed[crossing.word] = 1;
+                            workspace.expansions.push_back(crossing);
+                        }
+                        for (CrossingPlacement const &crossing : workspace.expansions)
+                        {
+                            workspace.placed[crossing.word] = 0;
+                        }
+                        workspace.expansions.insert(workspace.expansions.end(), workspace.other_placements.begin(),
+                                                    workspace.other_placements.end());
+
+                        std::size_t const count = std::min(m_beam_expansions, workspace.expansions.size());
+                        for (std::size_t i = 0; i < count; i++)
+                        {
+                            CrossingPlacement const &crossing = workspace.expansions[i];
+                            _Grid::Checkpoint const checkpoint = grid.checkpoint();
+                            grid.place_word_unchecked(crossing.word, crossing.placement);
+
+                            // Grids of the same step always miss the same number of
+                            // words, so rank them as if all words that can still be
+                            // placed were placed.
+                            for (auto const &[placement, word] : grid.get_placed_words())
+                            {
+                                workspace.placed[word] = 1;
+                            }
+                            std::int_fast32_t unplaceable_words = m_word_store->size() - m_candidate_words.size();
+                            for (wid const word : m_candidate_words)
+                            {
+                                if (!workspace.placed[word] && !grid.has_valid_placement(word))
+                                    unplaceable_words++;
+                            }
+                            for (auto const &[placement, word] : grid.get_placed_words())
+                            {
+                                workspace.placed[word] = 0;
+                            }
+
+                            expansions_by_state[state].push_back({static_cast<std::size_t>(state), crossing.word,
+                                                                  crossing.placement, score_grid(workspace.grid),
+                                                                  m_grid_scorer->score_grid(workspace.grid, unplaceable_words),
+                                                                  beam[state].key ^ placement_key(crossing.word, crossing.placement)});
+                            grid.rollback(checkpoint);
+                        }
+                    });
+
+        // keep the beam_width best distinct grids, ties in the order of their states
+        expansions.clear();
+        for (auto const &state_expansions : expansions_by_state)
+        {
+            expansions.insert(expansions.end(), state_expansions.begin(), state_expansions.end());
+        }
+        std::stable_sort(expansions.begin(), expansions.end(), [](Expansion const &a, Expansion const &b)
+                         { return a.potential_score > b.potential_score; });
+
+        std::vector<BeamState> next_beam;
+        keys.clear();
+        for (Expansion const &expansion : expansions)
+        {
+            if (next_beam.size() == m_beam_width)
+                break;
+            if (!keys.insert(expansion.key).second)
+                continue;
+
+            auto grid = std::make_shared<_Grid>(*beam[expansion.state].grid);
+            grid->place_word_unchecked(expansion.word, expansion.placement);
+            best.offer(expansion.grid_score, offered_grids++, grid);
+            next_beam.push_back({grid, expansion.key});
+        }
+        beam = std::move(next_beam);
+
+        if (!beam.empty() && placed_words % 10 == 0)
+        {
+            std::cout << "Placed " << placed_words + 1 << " words. The current best grid has a score of "
+                      << best.get_sorted().front().grid_score << "." << std::endl;
+        }
     }
-    grid_processor.join();
+
+    return best;
+}
+
+std::vector<Grid> Generator::generate()
+{
+    if (m_mode == GenerationMode::BEAM)
+    {
+        std::cout << "Searching grids with beam width " << m_beam_width << " on " << m_thread_count
+                  << " threads and choosing the best" << std::endl;
+    }
+    else
+    {
+        std::cout << "Generating " << m_gen_count << " grids on " << m_thread_count << " threads and choosing the best"
+                  << std::endl;
+    }
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    BestGrids best = m_mode == GenerationMode::BEAM         ? generate_with_beam_search()
+                     : m_scoring_mode == ScoringMode::LOCAL ? generate_with_local_scoring()
+                                                            : generate_with_central_scoring();
 
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = end - begin;
     auto dur_in_ms =
         std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-    std::cout << "Generated all " << m_gen_count << " grids!" << std::endl;
+    if (m_mode == GenerationMode::RESTARTS)
+    {
+        std::cout << "Generated all " << m_gen_count << " grids!" << std::endl;
+    }
     std::cout << "This took me a total of " << dur_in_ms / 1000.0 << " seconds."
               << std::endl;
-    std::cout << "The final grid has a score of " << highest_grid_score
-              << ". It is: " << std::endl;
-    best_grid->print_on_console();
 
-    gridBuffer->clear();
+    std::vector<Grid> best_grids;
+    for (auto const &scored : best.get_sorted())
+    {
+        best_grids.push_back(scored.grid);
+    }
+    if (!best_grids.empty())
+    {
+        std::cout << "The final grid has a score of " << best.get_sorted().front().grid_score
+                  << ". It is: " << std::endl;
+        best_grids.front()->print_on_console();
+    }
+
+    return best_grids;
+}
 
-    return best_grid;
+BestGrids::BestGrids(std::size_t capacity) : m_capacity(capacity)
+{
+    m_heap.reserve(capacity);
 }
 
-SharedGridBuffer::SharedGridBuffer(int number_of_threads) : m_number_of_threads(number_of_threads)
+namespace
 {
-    m_next_filled_grids_by_thread.resize(number_of_threads, 0);
-    for (int i = 0; i <= number_of_threads; i++)
+    bool better_grid(ScoredGrid const &lhs, ScoredGrid const &rhs)
     {
-        m_next_filled_grids_by_thread[i] = i;
+        // Equally scored grids are ordered by attempt. That way, the kept grids do
+        // not depend on the order in which the threads finish their attempts.
+        if (lhs.grid_score != rhs.grid_score)
+            return lhs.grid_score > rhs.grid_score;
+        return lhs.attempt < rhs.attempt;
     }
-    for (int i = 0; i < GRID_BUFFER_SIZE; i++)
+}
+
+// std::*_heap functions build max-heaps, thus use better_grid as less-than
+// comparison to keep the worst grid on top
+bool BestGrids::accepts(score grid_score, std::int_fast32_t attempt) const
+{
+    return m_heap.size() < m_capacity ||
+           better_grid({grid_score, attempt, nullptr}, m_heap.front());
+}
+
+bool BestGrids::offer(score grid_score, std::int_fast32_t attempt, Grid const &grid)
+{
+    if (!accepts(grid_score, attempt))
+        return false;
+
+    if (m_heap.size() == m_capacity)
     {
-        m_filed_grid_flags[i] = 0;
+        std::pop_heap(m_heap.begin(), m_heap.end(), better_grid);
+        m_heap.pop_back();
     }
+    m_heap.push_back({grid_score, attempt, grid});
+    std::push_heap(m_heap.begin(), m_heap.end(), better_grid);
+    return true;
 }
 
-void SharedGridBuffer::addNextGrid(int threadId, Grid const &grid)
+void BestGrids::merge(BestGrids const &other)
 {
-    int nextId = m_next_filled_grids_by_thread[threadId];
-    while (m_filed_grid_flags[nextId] != 0)
+    for (auto const &scored : other.m_heap)
     {
-        std::cout << "Warning:: Grid buffer is full. Processing grids is too slow!" << std::endl;
-        // wait until it is processed...
+        offer(scored.grid_score, scored.attempt, scored.grid);
     }
-    m_grid_buffer[nextId] = grid;
-    m_filed_grid_flags[nextId] = 1;
-    m_next_filled_grids_by_thread[threadId] = (nextId + m_number_of_threads) % GRID_BUFFER_SIZE;
 }
 
-Grid SharedGridBuffer::getNextGridToProcess()
+bool BestGrids::empty() const
+{
+    return m_heap.empty();
+}
+
+std::vector<ScoredGrid> BestGrids::get_sorted() const
 {
-    while (m_filed_grid_flags[m_next_processed_grid] == 0)
+    std::vector<ScoredGrid> sorted(m_heap);
+    std::sort_heap(sorted.begin(), sorted.end(), better_grid);
+    return sorted;
+}
+
+SharedGridBuffer::SharedGridBuffer()
+    : m_slots(std::make_unique<Slot[]>(GRID_BUFFER_SIZE)),
+      m_enqueue_pos(0), m_dequeue_pos(0), m_full_warning_printed(false)
+{
+    for (std::size_t i = 0; i < GRID_BUFFER_SIZE; i++)
+    {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+void SharedGridBuffer::addNextGrid(std::int_fast32_t attempt, Grid const &grid)
+{
+    Backoff backoff;
+    std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true)
+    {
+        slot = &m_slots[pos & (GRID_BUFFER_SIZE - 1)];
+        std::size_t const seq = slot->sequence.load(std::memory_order_acquire);
+        auto const diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+            // slot is free for this lap, try to claim it
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // slot still holds a grid of the previous lap, i.e. the buffer is full
+            if (!m_full_warning_printed.exchange(true, std::memory_order_relaxed))
+            {
+                std::cout << "Warning:: Grid buffer is full. Processing grids is too slow!" << std::endl;
+            }
+            backoff.pause();
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            // another producer claimed this slot in the meantime
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->attempt = attempt;
+    slot->grid = grid;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+Grid SharedGridBuffer::getNextGridToProcess(std::int_fast32_t &attempt)
+{
+    Backoff backoff;
+    Slot &slot = m_slots[m_dequeue_pos & (GRID_BUFFER_SIZE - 1)];
+    while (slot.sequence.load(std::memory_order_acquire) != m_dequeue_pos + 1)
     {
         // wait until grid is filled...
+        backoff.pause();
     }
-    Grid toReturn = m_grid_buffer[m_next_processed_grid];
-    m_filed_grid_flags[m_next_processed_grid] = 0;
-    m_next_processed_grid = (m_next_processed_grid + 1) % GRID_BUFFER_SIZE;
+    attempt = slot.attempt;
+    Grid toReturn = std::move(slot.grid);
+    slot.grid = nullptr;
+    // hand the slot back to the producers for the next lap
+    slot.sequence.store(m_dequeue_pos + GRID_BUFFER_SIZE, std::memory_order_release);
+    m_dequeue_pos++;
 
     return toReturn;
 }
 
 void SharedGridBuffer::clear()
 {
-    for (int i = 0; i < GRID_BUFFER_SIZE; i++)
+    for (std::size_t i = 0; i < GRID_BUFFER_SIZE; i++)
     {
-        m_grid_buffer[i] = nullptr;
+        m_slots[i].grid = nullptr;
     }
-}
\ No newline at end of file
+}
@@ -6,19 +6,32 @@
 #include "grid.h"
 
 // convenience macros for grid access at its only a 1D array internallly
-#define GIDX(row, col) ((row)*m_internal_column_count + col)
-
-// ATTENTION: These macros do not check for row/columns out-of-bounds!
-#define INC_ROW(gidx) (gidx += m_internal_column_count)
-#define INC_COLUMN(gidx) (++gidx)
-
-#define UP_CELL(gidx) (gidx - m_internal_column_count)
-#define DOWN_CELL(gidx) (gidx + m_internal_column_count)
-#define LEFT_CELL(gidx) (gidx - 1)
-#define RIGHT_CELL(gidx) (gidx + 1)
+// +1 skips the sentinel row above and the sentinel column left of the grid
+#define GIDX(row, col) (((row) + 1) * m_grid_stride + (col) + 1)
 
 using namespace Crossword;
 
+namespace
+{
+    // Number of letters checked at once by is_valid_placement. Together with the
+    // cells before and after them, they have to fit into 64 bits.
+    constexpr gidx LETTERS_PER_WINDOW = 62;
+
+    /**
+        Returns count (1 to 64) bits of a bitboard line, starting with bit
+        first_bit. Each line must have one spare word at its end.
+     */
+    std::uint64_t get_window(std::uint64_t const *board, gidx stride, gidx line,
+                             gidx first_bit, gidx count)
+    {
+        std::uint64_t const *words = board + line * stride + first_bit / 64;
+        gidx const offset = first_bit % 64;
+        // shift in two steps, as shifting by 64 is undefined for offset 0
+        std::uint64_t const bits = (words[0] >> offset) | ((words[1] << 1) << (63 - offset));
+        return bits & (~std::uint64_t{0} >> (64 - count));
+    }
+}
+
 char const _Grid::EMPTY_CHAR = '.';
 
 bool Location::operator<(Location const &other) const
@@ -34,9 +47,15 @@ bool Location::operator<(Location const &other) const
     return row < other.row;
 }
 
-_Grid::_Grid(gidx max_row_count, gidx max_column_count)
+_Grid::_Grid(gidx max_row_count, gidx max_column_count,
+             std::shared_ptr<WordStore const> word_store)
     : m_internal_row_count(2 * max_row_count),
-      m_internal_column_count(2 * max_column_count), m_crossing_count(0),
+      m_internal_column_count(2 * max_column_count),
+      m_grid_stride(m_internal_column_count + 2),
+      m_word_store(std::move(word_store)),
+      m_word_starts(MIN_WORD_START_CAPACITY, {Placement{0}, WordStore::NO_WORD}), m_word_start_count(0),
+      m_placed_letter_count(0), m_placed_letter_mask(0), m_letter_bit_cells{},
+      m_crossing_count(0),
       m_max_row_count(max_row_count), m_max_column_count(max_column_count),
       // First word will be placed in the center of the internal grid.
       // This is the passed row/column count, as row/column count is doubled
@@ -48,12 +67,62 @@ _Grid::_Grid(gidx max_row_count, gidx max_column_count)
     // That way, we can simply place the first word in the middle of the grid
     // and still have space in all directions. Thus, we do not restrict possible
     // solutions due to unfortunate placements of the first word.
-    gidx gridsize = max_row_count * 2 * max_column_count * 2;
-    m_grid = std::make_unique<char[]>(gridsize);
-    std::fill(m_grid.get(), m_grid.get() + gridsize, EMPTY_CHAR);
+    // The grid is surrounded by a border of sentinel cells that always stay
+    // empty, so that the neighbours of every grid cell can be accessed without
+    // bounds checks.
+    gidx gridsize = (m_internal_row_count + 2) * m_grid_stride;
+    m_grid.assign(gridsize, EMPTY_CHAR);
+    m_cell_usage.assign(gridsize, 0);
+
+    // Bitboards use the same padded coordinates, i.e. bit (row + 1, col + 1)
+    // is the cell (row, col). Each line gets one spare word for get_window.
+    m_row_bits_stride = m_grid_stride / 64 + 2;
+    m_column_bits_stride = (m_internal_row_count + 2) / 64 + 2;
+    m_row_bits.assign((m_internal_row_count + 2) * m_row_bits_stride, 0);
+    m_column_bits.assign(m_grid_stride * m_column_bits_stride, 0);
+}
+
+void _Grid::reset()
+{
+    // every non-empty cell is listed in the letter lookup
+    for (auto &cells : m_letter_cells)
+    {
+        for (auto const &cell : cells)
+        {
+            m_grid[cell] = EMPTY_CHAR;
+            m_cell_usage[cell] = 0;
+            set_occupied(cell, false);
+        }
+        cells.clear();
+    }
+    m_placed_letter_count = 0;
+    m_placed_letter_mask = 0;
+    m_letter_bit_cells.fill(0);
+    std::fill(m_word_starts.begin(), m_word_starts.end(), WordStart{Placement{0}, WordStore::NO_WORD});
+    m_word_start_count = 0;
+    m_words.clear();
+    m_crossing_count = 0;
+    m_undo_log.clear();
+
+    m_min_row_used = m_max_row_count;
+    m_max_row_used = m_max_row_count;
+    m_min_column_used = m_max_column_count;
+    m_max_column_used = m_max_column_count;
+}
+
+Placement _Grid::to_placement(Location const &loc) const
+{
+    return Placement::make(GIDX(loc.row, loc.column), loc.direction);
 }
 
-bool _Grid::is_in_bounds(Word const &word, Location const &loc) const
+Location _Grid::to_location(Placement placement) const
+{
+    gidx const cell = placement.cell();
+    // -1 to skip the sentinel row and column
+    return {cell / m_grid_stride - 1, cell % m_grid_stride - 1, placement.direction()};
+}
+
+bool _Grid::is_in_bounds(WordView const &word, Location const &loc, PlacementFeatures &features) const
 {
     gidx start_row = loc.row;
     gidx start_col = loc.column;
@@ -63,132 +132,291 @@ bool _Grid::is_in_bounds(Word const &word, Location const &loc) const
 
     bool out_of_bounds = start_row < 0 || end_row >= m_internal_row_count;
     out_of_bounds |= start_col < 0 || end_col >= m_internal_column_count;
-    out_of_bounds |= std::max(end_col, m_max_column_used) -
-                         std::min(start_col, m_min_column_used) >=
-                     m_max_column_count;
-    out_of_bounds |=
-        std::max(end_row, m_max_row_used) - std::min(start_row, m_min_row_used) >=
-        m_max_row_count;
-
+    // last used column/row - first used column/row after the placement
+    gidx const column_span = std::max(end_col, m_max_column_used) - std::min(start_col, m_min_column_used);
+    gidx const row_span = std::max(end_row, m_max_row_used) - std::min(start_row, m_min_row_used);
+    out_of_bounds |= column_span >= m_max_column_count;
+    out_of_bounds |= row_span >= m_max_row_count;
+
+    features.added_rows = row_span - (m_max_row_used - m_min_row_used);
+    features.added_columns = column_span - (m_max_column_used - m_min_column_used);
     return !out_of_bounds;
 }
 
-bool _Grid::is_valid_placement(Word const &word, Location const &loc) const
+bool _Grid::is_valid_placement(WordView const &word, Location const &loc, PlacementFeatures &features) const
 {
-    if (!is_in_bounds(word, loc))
+    if (!is_in_bounds(word, loc, features))
         return false;
 
-    gidx start_row = loc.row;
-    gidx start_col = loc.column;
-    // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
-    gidx end_row = loc.row + (word.length - 1) * (1 - loc.direction);
-    gidx end_col = loc.column + (word.length - 1) * loc.direction;
+    // Both directions are checked the same way, only on different bitboards:
+    // a horizontal word spans a part of a row and its neighbours are the rows
+    // above and below, a vertical word spans a part of a column and its
+    // neighbours are the columns left and right.
+    bool const horizontal = loc.direction == Direction::HORIZONTAL;
+    std::uint64_t const *board = horizontal ? m_row_bits.data() : m_column_bits.data();
+    gidx const board_stride = horizontal ? m_row_bits_stride : m_column_bits_stride;
+    // +1 to convert to the padded bitboard coordinates
+    gidx const line = (horizontal ? loc.row : loc.column) + 1;
+    gidx const first = (horizontal ? loc.column : loc.row) + 1;
+    gidx const step = horizontal ? 1 : m_grid_stride;
+    gidx const start_cell = GIDX(loc.row, loc.column);
+
+    features.crossings = 0;
+    for (gidx done = 0; done < word.length; done += LETTERS_PER_WINDOW)
+    {
+        gidx const count = std::min<gidx>(LETTERS_PER_WINDOW, word.length - done);
+        // bit 0 of the windows is the cell before the letters checked in this
+        // round, bit count + 1 the cell after them
+        gidx const window_start = first + done - 1;
+        std::uint64_t const occupied = get_window(board, board_stride, line, window_start, count + 2);
+        std::uint64_t const neighbours = get_window(board, board_stride, line - 1, window_start, count + 2) |
+                                         get_window(board, board_stride, line + 1, window_start, count + 2);
+        std::uint64_t const letters = ((std::uint64_t{1} << count) - 1) << 1;
+        std::uint64_t const crossings = occupied & letters;
+
+        // if a cell of the word is empty, its neighbours must be empty as well
+        std::uint64_t conflicts = neighbours & letters & ~occupied;
+        // If we have a valid crossing, the next cell must be free! If this is not
+        // the case, there is already another word placed here with the same
+        // orientation. Needed to prevent placing a word on a word with
+        // overlapping suffix/prefix. Like "testtest" on "testt"
+        conflicts |= (crossings << 1) & occupied;
+        // the cells before and after the word must be empty
+        if (done == 0)
+            conflicts |= occupied & 1;
+        if (done + count == word.length)
+            conflicts |= occupied & (std::uint64_t{1} << (count + 1));
+        if (conflicts != 0)
+            return false;
+
+        // only crossings have to be compared letter by letter
+        features.crossings += __builtin_popcountll(crossings);
+        for (std::uint64_t bits = crossings; bits != 0; bits &= bits - 1)
+        {
+            gidx const c = done + __builtin_ctzll(bits) - 1;
+            if (m_grid[start_cell + c * step] != word[c])
+                return false;
+        }
+    }
+    return true;
+}
 
-    gidx cell = GIDX(start_row, start_col);
-    bool conflict = false;
-    switch (loc.direction)
+bool _Grid::is_valid_placement(wid word, Placement placement) const
+{
+    PlacementFeatures features;
+    return is_valid_placement(m_word_store->get_word(word), to_location(placement), features);
+}
+
+bool _Grid::is_valid_placement(wid word, Placement placement, PlacementFeatures &features) const
+{
+    return is_valid_placement(m_word_store->get_word(word), to_location(placement), features);
+}
+
+void _Grid::set_occupied(gidx cell, bool occupied)
+{
+    gidx const row = cell / m_grid_stride;
+    gidx const col = cell % m_grid_stride;
+    std::uint64_t &row_bits = m_row_bits[row * m_row_bits_stride + col / 64];
+    std::uint64_t &column_bits = m_column_bits[col * m_column_bits_stride + row / 64];
+    if (occupied)
     {
-    case Direction::HORIZONTAL:
-        // check cells before and after the word
-        conflict |= start_col > 0 && m_grid[LEFT_CELL(cell)] != EMPTY_CHAR;
-        conflict |= end_col + 1 < m_internal_column_count &&
-                    m_grid[RIGHT_CELL(GIDX(end_row, end_col))] != EMPTY_CHAR;
+        row_bits |= std::uint64_t{1} << (col % 64);
+        column_bits |= std::uint64_t{1} << (row % 64);
+    }
+    else
+    {
+        row_bits &= ~(std::uint64_t{1} << (col % 64));
+        column_bits &= ~(std::uint64_t{1} << (row % 64));
+    }
+}
+
+void _Grid::add_letter_cell(char letter, gidx cell)
+{
+    // keep the cells sorted, so that the order of valid placements does not
+    // depend on the placement order
+    auto &cells = m_letter_cells[letter_code(letter)];
+    cells.insert(std::upper_bound(cells.begin(), cells.end(), cell), cell);
+
+    letter_mask const bit = WordStore::get_letter_bit(letter);
+    if (m_letter_bit_cells[__builtin_ctz(bit)]++ == 0)
+        m_placed_letter_mask |= bit;
+}
+
+void _Grid::remove_letter_cell(char letter, gidx cell)
+{
+    auto &cells = m_letter_cells[letter_code(letter)];
+    cells.erase(std::lower_bound(cells.begin(), cells.end(), cell));
 
-        for (auto c = 0; c < word.length; c++)
+    letter_mask const bit = WordStore::get_letter_bit(letter);
+    if (--m_letter_bit_cells[__builtin_ctz(bit)] == 0)
+        m_placed_letter_mask &= ~bit;
+}
+
+void _Grid::write_word(WordView const &word, Placement placement)
+{
+    gidx cell = placement.cell();
+    gidx const step = placement.direction() == Direction::HORIZONTAL ? 1 : m_grid_stride;
+    for (auto i = 0; i < word.length; i++, cell += step)
+    {
+        if (m_cell_usage[cell]++ > 0)
         {
-            if (m_grid[cell] == EMPTY_CHAR)
-            {
-                // if this cell is empty, the one above and below musst be empty as well
-                if (start_row > 0)
-                    conflict |= m_grid[UP_CELL(cell)] != EMPTY_CHAR;
-                if (start_row + 1 < m_internal_row_count)
-                    conflict |= m_grid[DOWN_CELL(cell)] != EMPTY_CHAR;
-            }
-            else
-            {
-                // As this cell is not empty, it must be the same value as the
-                // letter of the word that we want to place here.
-                conflict |= m_grid[cell] != word[c];
-
-                // If we have a valid crossing here, the next character must be free!
-                // If this is not the case, this means there is already another word
-                // placed here with the same orientation. Needed to prevent placing a
-                // word on a word with overlapping suffix/prefix. Like "testtest" on
-                // "testt"
-                conflict |=
-                    m_grid[cell] == word[c] && m_grid[RIGHT_CELL(cell)] != EMPTY_CHAR;
-            }
-
-            INC_COLUMN(cell); // afterwards as we have to check letter 0 as well
+            m_crossing_count++;
+            if (m_grid[cell] == word[i])
+                continue;
+            // unchecked placement overwrites the letter of the crossing word
+            remove_letter_cell(m_grid[cell], cell);
         }
-        break;
-    case Direction::VERTICAL:
-        // check cells above and below the word
-        conflict |= start_row > 0 && m_grid[UP_CELL(cell)] != EMPTY_CHAR;
-        conflict |= end_row + 1 < m_internal_row_count &&
-                    m_grid[DOWN_CELL(GIDX(end_row, end_col))] != EMPTY_CHAR;
+        else
+        {
+            m_placed_letter_count++;
+            set_occupied(cell, true);
+        }
+
+        add_letter_cell(word[i], cell);
+        m_grid[cell] = word[i];
+    }
+}
 
-        for (auto c = 0; c < word.length; c++)
+void _Grid::erase_word(WordView const &word, Placement placement)
+{
+    gidx cell = placement.cell();
+    gidx const step = placement.direction() == Direction::HORIZONTAL ? 1 : m_grid_stride;
+    for (auto i = 0; i < word.length; i++, cell += step)
+    {
+        if (--m_cell_usage[cell] > 0)
         {
-            if (m_grid[cell] == EMPTY_CHAR)
-            {
-                // if this cell is empty, the one left and right musst be empty as well
-                if (start_col > 0)
-                    conflict |= m_grid[LEFT_CELL(cell)] != EMPTY_CHAR;
-                if (start_col + 1 < m_internal_column_count)
-                    conflict |= m_grid[RIGHT_CELL(cell)] != EMPTY_CHAR;
-            }
-            else
-            {
-                // As this cell is not empty, it must be the same value as the
-                // letter of the word that we want to place here.
-                conflict |= m_grid[cell] != word[c];
-
-                // If we have a valid crossing here, the next character must be free!
-                // If this is not the case, this means there is already another word
-                // placed here with the same orientation. Needed to prevent placing a
-                // word on a word with overlapping suffix/prefix. Like "testtest" on
-                // "testt"
-                conflict |=
-                    m_grid[cell] == word[c] && m_grid[DOWN_CELL(cell)] != EMPTY_CHAR;
-            }
-
-            INC_ROW(cell);
+            // letter is still used by the crossing word
+            m_crossing_count--;
+            continue;
         }
-        break;
+
+        remove_letter_cell(m_grid[cell], cell);
+        m_grid[cell] = EMPTY_CHAR;
+        set_occupied(cell, false);
+        m_placed_letter_count--;
     }
-    return !conflict;
 }
 
-bool _Grid::place_word_unchecked(Word const &word, Location const &loc)
+std::size_t _Grid::get_word_start_slot(Placement placement) const
 {
-    gidx cell = GIDX(loc.row, loc.column);
-    switch (loc.direction)
+    // Fibonacci hashing, neighbouring placements get distant slots
+    return static_cast<std::size_t>((placement.packed * 0x9E3779B97F4A7C15ull) >> 32) & (m_word_starts.size() - 1);
+}
+
+wid _Grid::find_word_start(Placement placement) const
+{
+    std::size_t const mask = m_word_starts.size() - 1;
+    for (std::size_t slot = get_word_start_slot(placement);; slot = (slot + 1) & mask)
     {
-    case Direction::HORIZONTAL:
-        for (auto i = 0; i < word.length; i++)
+        WordStart const &start = m_word_starts[slot];
+        if (start.word == WordStore::NO_WORD || start.placement == placement)
+            return start.word;
+    }
+}
+
+void _Grid::add_word_start(Placement placement, wid word)
+{
+    if (2 * (m_word_start_count + 1) > m_word_starts.size())
+    {
+        std::vector<WordStart> starts(2 * m_word_starts.size(), {Placement{0}, WordStore::NO_WORD});
+        std::swap(starts, m_word_starts);
+        m_word_start_count = 0;
+        for (WordStart const &start : starts)
         {
-            if (m_grid[cell] != EMPTY_CHAR)
-                m_crossing_count++;
+            if (start.word != WordStore::NO_WORD)
+                add_word_start(start.placement, start.word);
+        }
+    }
 
-            m_grid[cell] = word[i];
-            m_char_loc_lookup[word[i]].insert(cell);
-            INC_COLUMN(cell);
+    std::size_t const mask = m_word_starts.size() - 1;
+    std::size_t slot = get_word_start_slot(placement);
+    while (m_word_starts[slot].word != WordStore::NO_WORD)
+    {
+        slot = (slot + 1) & mask;
+    }
+    m_word_starts[slot] = {placement, word};
+    m_word_start_count++;
+}
+
+void _Grid::remove_word_start(Placement placement)
+{
+    std::size_t const mask = m_word_starts.size() - 1;
+    std::size_t slot = get_word_start_slot(placement);
+    while (!(m_word_starts[slot].placement == placement) || m_word_starts[slot].word == WordStore::NO_WORD)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    // Shift following entries of the probe sequence back into the gap, unless
+    // their home slot lies cyclically after the gap, so no lookup stops early.
+    for (std::size_t next = (slot + 1) & mask; m_word_starts[next].word != WordStore::NO_WORD; next = (next + 1) & mask)
+    {
+        std::size_t const home = get_word_start_slot(m_word_starts[next].placement);
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            m_word_starts[slot] = m_word_starts[next];
+            slot = next;
         }
+    }
+    m_word_starts[slot].word = WordStore::NO_WORD;
+    m_word_start_count--;
+}
+
+void _Grid::push_undo_entry(bool placed, Placement placement, wid word)
+{
+    m_undo_log.push_back({placed, placement, word, m_crossing_count,
+                          m_min_row_used, m_max_row_used,
+                          m_min_column_used, m_max_column_used});
+}
+
+void _Grid::restore_bounds(UndoEntry const &entry)
+{
+    m_min_row_used = entry.min_row_used;
+    m_max_row_used = entry.max_row_used;
+    m_min_column_used = entry.min_column_used;
+    m_max_column_used = entry.max_column_used;
+}
+
+void _Grid::recompute_bounds()
+{
+    m_min_row_used = m_max_row_count;
+    m_max_row_used = m_max_row_count;
+    m_min_column_used = m_max_column_count;
+    m_max_column_used = m_max_column_count;
+    if (m_words.empty())
+        return;
+
+    m_min_row_used = m_min_column_used = std::max(m_internal_row_count, m_internal_column_count);
+    m_max_row_used = m_max_column_used = 0;
+    for (auto const &[placement, id] : m_words)
+    {
+        WordView const word = m_word_store->get_word(id);
+        Location const loc = to_location(placement);
+        // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
+        gidx end_row = loc.row + (word.length - 1) * (1 - loc.direction);
+        gidx end_col = loc.column + (word.length - 1) * loc.direction;
+        m_min_row_used = std::min(m_min_row_used, loc.row);
+        m_max_row_used = std::max(m_max_row_used, end_row);
+        m_min_column_used = std::min(m_min_column_used, loc.column);
+        m_max_column_used = std::max(m_max_column_used, end_col);
+    }
+}
+
+bool _Grid::place_word_unchecked(wid id, Placement placement)
+{
+    WordView const word = m_word_store->get_word(id);
+    push_undo_entry(true, placement, id);
+    write_word(word, placement);
+
+    Location const loc = to_location(placement);
+    switch (loc.direction)
+    {
+    case Direction::HORIZONTAL:
         m_max_row_used = std::max(m_max_row_used, loc.row);
         m_max_column_used =
             std::max(m_max_column_used, loc.column + word.length - 1);
         break;
     case Direction::VERTICAL:
-        for (auto i = 0; i < word.length; i++)
-        {
-            if (m_grid[cell] != EMPTY_CHAR)
-                m_crossing_count++;
-
-            m_grid[cell] = word[i];
-            m_char_loc_lookup[word[i]].insert(cell);
-            INC_ROW(cell);
-        }
         m_max_row_used = std::max(m_max_row_used, loc.row + word.length - 1);
         m_max_column_used = std::max(m_max_column_used, loc.column);
         break;
@@ -196,26 +424,67 @@ bool _Grid::place_word_unchecked(Word const &word, Location const &loc)
     m_min_column_used = std::min(m_min_column_used, loc.column);
     m_min_row_used = std::min(m_min_row_used, loc.row);
 
-    std::pair<Location, Word> placement(loc, word);
-    m_words.insert(std::move(placement));
+    if (m_words.emplace(placement, id).second)
+        add_word_start(placement, id);
 
     return true;
 }
 
-bool _Grid::place_word(Word const &word, Location const &loc)
+bool _Grid::remove_word(Placement placement)
 {
-    if (!is_valid_placement(word, loc))
+    auto it = m_words.find(placement);
+    if (it == m_words.end())
         return false;
 
-    return place_word_unchecked(word, loc);
+    push_undo_entry(false, placement, it->second);
+    erase_word(m_word_store->get_word(it->second), placement);
+    m_words.erase(it);
+    remove_word_start(placement);
+    recompute_bounds();
+
+    return true;
 }
 
-bool _Grid::place_first_word(Word const &word, Direction direction)
+_Grid::Checkpoint _Grid::checkpoint() const
 {
-    if (!m_words.empty())
+    return m_undo_log.size();
+}
+
+void _Grid::rollback(Checkpoint checkpoint)
+{
+    while (m_undo_log.size() > checkpoint)
     {
-        return false;
+        UndoEntry const &entry = m_undo_log.back();
+        WordView const word = m_word_store->get_word(entry.word);
+        if (entry.placed)
+        {
+            erase_word(word, entry.placement);
+            if (m_words.erase(entry.placement) > 0)
+                remove_word_start(entry.placement);
+        }
+        else
+        {
+            write_word(word, entry.placement);
+            if (m_words.emplace(entry.placement, entry.word).second)
+                add_word_start(entry.placement, entry.word);
+        }
+        m_crossing_count = entry.crossing_count;
+        restore_bounds(entry);
+        m_undo_log.pop_back();
     }
+}
+
+bool _Grid::place_word(wid word, Placement placement)
+{
+    if (!is_valid_placement(word, placement))
+        return false;
+
+    return place_word_unchecked(word, placement);
+}
+
+Placement _Grid::get_first_word_placement(wid id, Direction direction) const
+{
+    WordView const word = m_word_store->get_word(id);
 
     // calculate the start position of the word, so that its in the middle of the
     // grid
@@ -231,34 +500,90 @@ bool _Grid::place_first_word(Word const &word, Direction direction)
         break;
     }
 
-    return place_word(word, loc);
+    return to_placement(loc);
 }
 
-void _Grid::get_valid_placements(Word const &word,
-                                 std::vector<Location> &buffer) const
+bool _Grid::place_first_word(wid id, Direction direction)
 {
+    if (!m_words.empty())
+    {
+        return false;
+    }
+
+    return place_word(id, get_first_word_placement(id, direction));
+}
+
+void _Grid::get_valid_placements(wid id,
+                                 std::vector<Placement> &buffer) const
+{
+    for_each_valid_placement(id, [&buffer](CrossingPlacement const &crossing) {
+        buffer.push_back(crossing.placement);
+    });
+}
+
+void _Grid::get_valid_placements(wid id,
+                                 std::vector<CrossingPlacement> &buffer) const
+{
+    for_each_valid_placement(id, [&buffer](CrossingPlacement const &crossing) {
+        buffer.push_back(crossing);
+    });
+}
+
+bool _Grid::has_valid_placement(wid id) const
+{
+    if ((m_word_store->get_letter_mask(id) & m_placed_letter_mask) == 0)
+        return false;
+
+    WordView const word = m_word_store->get_word(id);
+    PlacementFeatures features;
     for (auto cidx = 0; cidx < word.length; cidx++)
     {
-        auto const &letter = word[cidx];
-        if (m_char_loc_lookup.count(letter) > 0)
+        for (auto const &cell : m_letter_cells[letter_code(word[cidx])])
         {
-            for (auto const &cell : m_char_loc_lookup.at(letter))
-            {
-                gidx const row = cell / m_internal_column_count;
-                gidx const col = cell % m_internal_column_count;
-                Location loc = {row - cidx, col, Direction::VERTICAL};
-                if (is_valid_placement(word, loc))
-                {
-                    buffer.push_back(loc);
-                }
-                loc = {row, col - cidx, Direction::HORIZONTAL};
-                if (is_valid_placement(word, loc))
-                {
-                    buffer.push_back(loc);
-                }
-            }
+            gidx const row = cell / m_grid_stride - 1;
+            gidx const col = cell % m_grid_stride - 1;
+            if (is_valid_placement(word, {row - cidx, col, Direction::VERTICAL}, features) ||
+                is_valid_placement(word, {row, col - cidx, Direction::HORIZONTAL}, features))
+                return true;
         }
     }
+    return false;
+}
+
+letter_mask _Grid::get_new_cells(Placement placement, std::vector<gidx> &buffer) const
+{
+    WordView const word = m_word_store->get_word(find_word_start(placement));
+    gidx cell = placement.cell();
+    gidx const step = placement.direction() == Direction::HORIZONTAL ? 1 : m_grid_stride;
+
+    letter_mask mask = 0;
+    for (auto i = 0; i < word.length; i++, cell += step)
+    {
+        if (m_cell_usage[cell] > 1)
+            continue;
+
+        buffer.push_back(cell);
+        mask |= WordStore::get_letter_bit(word[i]);
+    }
+    return mask;
+}
+
+void _Grid::get_crossing_placements(wid id, std::uint32_t offset, gidx cell,
+                                    std::vector<CrossingPlacement> &buffer) const
+{
+    WordView const word = m_word_store->get_word(id);
+    gidx const cidx = offset;
+    gidx const row = cell / m_grid_stride - 1;
+    gidx const col = cell % m_grid_stride - 1;
+    PlacementFeatures features;
+    if (is_valid_placement(word, {row - cidx, col, Direction::VERTICAL}, features))
+    {
+        buffer.push_back({id, offset, cell, Placement::make(cell - cidx * m_grid_stride, Direction::VERTICAL), features});
+    }
+    if (is_valid_placement(word, {row, col - cidx, Direction::HORIZONTAL}, features))
+    {
+        buffer.push_back({id, offset, cell, Placement::make(cell - cidx, Direction::HORIZONTAL), features});
+    }
 }
 
 std::int_fast32_t _Grid::get_height() const
@@ -273,12 +598,17 @@ std::int_fast32_t _Grid::get_width() const
 
 std::int_fast32_t _Grid::get_placed_letter_count() const
 {
-    std::int_fast32_t count = 0;
-    for (auto const &[key, char_locs] : m_char_loc_lookup)
-    {
-        count += char_locs.size();
-    }
-    return count;
+    return m_placed_letter_count;
+}
+
+letter_mask _Grid::get_placed_letter_mask() const
+{
+    return m_placed_letter_mask;
+}
+
+WordStore const &_Grid::get_word_store() const
+{
+    return *m_word_store;
 }
 
 std::int_fast32_t _Grid::get_placed_word_count() const
@@ -299,18 +629,26 @@ char _Grid::get_cell_content(gidx row, gidx column) const
     return m_grid[GIDX(m_min_row_used + row, m_min_column_used + column)];
 }
 
-Word const *_Grid::get_word_starting_at(gidx row, gidx column,
+char _Grid::get_cell_letter(gidx cell) const
+{
+    return m_grid[cell];
+}
+
+wid _Grid::get_word_starting_at(gidx row, gidx column,
                                         Direction dir) const
 {
+    // words only start within the used part of the grid
+    if (row < 0 || row >= get_height() || column < 0 || column >= get_width())
+        return WordStore::NO_WORD;
+
     row += m_min_row_used;
     column += m_min_column_used;
-    Location const loc = {row, column, dir};
+    return find_word_start(Placement::make(GIDX(row, column), dir));
+}
 
-    if (m_words.count(loc) > 0)
-    {
-        return &m_words.at(loc);
-    }
-    return nullptr;
+std::map<Placement, wid> const &_Grid::get_placed_words() const
+{
+    return m_words;
 }
 
 void _Grid::print_on_console(bool full_internal_grid) const
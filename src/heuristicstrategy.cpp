@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+#include "heuristicstrategy.h"
+
+using namespace Crossword;
+
+HeuristicStrategy::HeuristicStrategy(Heuristic heuristic, double temperature,
+                                     WordStore const &words, WordAnalysis const &analysis,
+                                     INIReader const &config)
+    : PlacementStrategy(config), m_values(words.size()), m_temperature(temperature)
+{
+    for (wid id = 0; id < words.size(); id++)
+    {
+        m_values[id] = heuristic == Heuristic::LENGTH ? words.get_length(id)
+                                                      : analysis.get_crossability(id);
+    }
+    double const max_value = m_values.empty() ? 0.0 : *std::max_element(m_values.begin(), m_values.end());
+    if (max_value > 0.0)
+    {
+        for (double &value : m_values)
+        {
+            value /= max_value;
+        }
+    }
+
+    std::cout << "Initialized heuristic placement strategy. Heuristic: "
+              << (heuristic == Heuristic::LENGTH ? "longest" : "crossable")
+              << ", temperature: " << m_temperature << std::endl;
+}
+
+void HeuristicStrategy::order_words(std::vector<wid> &words, Rng &rng) const
+{
+    if (m_temperature == 0.0)
+    {
+        // greedy, words with the same value are tried in random order
+        rng.shuffle(words.begin(), words.end());
+        std::stable_sort(words.begin(), words.end(), [this](wid a, wid b)
+                         { return m_values[a] > m_values[b]; });
+        return;
+    }
+
+    // Sorting by value / temperature plus Gumbel distributed noise draws words
+    // one after another with probability proportional to exp(value / temperature).
+    // The buffer is reused by all attempts of a worker thread.
+    thread_local std::vector<std::pair<double, wid>> priorities;
+    priorities.clear();
+    for (wid const word : words)
+    {
+        priorities.emplace_back(m_values[word] / m_temperature - std::log(-std::log(rng.uniform())), word);
+    }
+    std::sort(priorities.begin(), priorities.end(), [](auto const &a, auto const &b)
+              { return a.first > b.first; });
+    for (std::size_t i = 0; i < words.size(); i++)
+    {
+        words[i] = priorities[i].second;
+    }
+}
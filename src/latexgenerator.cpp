@@ -1,13 +1,17 @@
 #include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 
 #include "latexgenerator.h"
 
 using namespace Crossword;
 
-void LatexGenerator::add_preamble(std::ofstream &of) const
+void LatexGenerator::add_preamble(std::string &doc) const
 {
-    of << R"""(
+    doc += R"""(
 \documentclass{article}
 
 \usepackage{amssymb}
@@ -23,47 +27,58 @@ void LatexGenerator::add_preamble(std::ofstream &of) const
 )""";
 }
 
-void LatexGenerator::add_puzzle_macros(std::ofstream &of) const
+void LatexGenerator::add_puzzle_macros(std::string &doc) const
 {
-    of << R"""(
+    doc += R"""(
 \renewcommand{\PuzzleUnitlength}{13pt}
 \newcommand{\cluer}[1]{\textbf{#1}^\blacktriangleright}
 \newcommand{\clued}[1]{\textbf{#1}\blacktriangledown}
 )""";
 }
 
-void LatexGenerator::add_puzzle(Grid const &grid, std::ofstream &of) const
+void LatexGenerator::add_puzzle(Grid const &grid, std::string &doc) const
 {
     // add 1 to height and width as we place the word-starting markers in the cell above
     // or left of the first cell of the word (depending on the orientation)
-    of << std::endl
-       << "\\begin{Puzzle}{"
-       << grid->get_width() + 1 << "}{" << grid->get_height() + 1 << "}" << std::endl;
+    doc += "\n\\begin{Puzzle}{";
+    doc += std::to_string(grid->get_width() + 1);
+    doc += "}{";
+    doc += std::to_string(grid->get_height() + 1);
+    doc += "}\n";
 
     // lambda to construct a single cell string
-    auto fill_cell = [&, grid](std::ofstream &of, char cell_content,
-                               std::int_fast32_t vert_marker, std::int_fast32_t hori_marker)
+    auto fill_cell = [&doc](char cell_content,
+                            std::int_fast32_t vert_marker, std::int_fast32_t hori_marker)
     {
-        of << "|";
+        doc += '|';
 
         // add marker to mark the beginning of a word
         if (vert_marker > 0 || hori_marker > 0)
         {
-            of << "[$";
+            doc += "[$";
             if (vert_marker > 0)
-                of << "_{\\clued{" << vert_marker << "}}";
+            {
+                doc += "_{\\clued{";
+                doc += std::to_string(vert_marker);
+                doc += "}}";
+            }
             if (hori_marker > 0)
-                of << "^{\\cluer{" << hori_marker << "}}";
-            of << "$]";
+            {
+                doc += "^{\\cluer{";
+                doc += std::to_string(hori_marker);
+                doc += "}}";
+            }
+            doc += "$]";
         }
 
         if (cell_content == _Grid::EMPTY_CHAR)
         {
-            of << "{}";
+            doc += "{}";
         }
         else
         {
-            of << " " << cell_content;
+            doc += ' ';
+            doc += cell_content;
         }
     };
 
@@ -72,91 +87,171 @@ void LatexGenerator::add_puzzle(Grid const &grid, std::ofstream &of) const
     {
         for (auto j = 0; j <= grid->get_width(); j++)
         {
-            Word const *vword = grid->get_word_starting_at(i, j - 1, Direction::VERTICAL);
-            Word const *hword = grid->get_word_starting_at(i - 1, j, Direction::HORIZONTAL);
+            wid const vword = grid->get_word_starting_at(i, j - 1, Direction::VERTICAL);
+            wid const hword = grid->get_word_starting_at(i - 1, j, Direction::HORIZONTAL);
             auto vmarker = 0, hmarker = 0;
-            if (vword != nullptr)
+            if (vword != WordStore::NO_WORD)
                 vmarker = ++vert_count;
-            if (hword != nullptr)
+            if (hword != WordStore::NO_WORD)
                 hmarker = ++hori_count;
-            fill_cell(of, grid->get_cell_content(i - 1, j - 1), vmarker, hmarker);
+            fill_cell(grid->get_cell_content(i - 1, j - 1), vmarker, hmarker);
         }
-        of << "|." << std::endl;
+        doc += "|.\n";
     }
-    of << "\\end{Puzzle}" << std::endl
-       << std::endl;
+    doc += "\\end{Puzzle}\n\n";
 }
 
-void LatexGenerator::add_hints(Grid const &grid, std::ofstream &of) const
+void LatexGenerator::add_hints(Grid const &grid, std::string &doc) const
 {
-    of << "\\begin{multicols*}{2}" << std::endl;
-    of << "VERTICAL CLUES" << std::endl;
-    of << "\\begin{enumerate}" << std::endl;
-    for (auto i = 0; i <= grid->get_height(); i++)
+    auto add_clues = [&grid, &doc](Direction direction)
     {
-        for (auto j = 0; j <= grid->get_width(); j++)
+        // placed words are ordered like the cells, so clues are numbered as in add_puzzle
+        for (auto const &[placement, id] : grid->get_placed_words())
         {
-            Word const *vword = grid->get_word_starting_at(i, j, Direction::VERTICAL);
-            if (vword != nullptr)
+            if (placement.direction() == direction)
             {
-                of << "\\item " << vword->clue << std::endl;
+                doc += "\\item ";
+                doc += grid->get_word_store().get_clue(id);
+                doc += '\n';
             }
         }
-    }
-    of << "\\end{enumerate}" << std::endl;
-    of << "\\vfill\\null" << std::endl;
-    of << "\\columnbreak" << std::endl;
+    };
 
-    of << "HORIZONTAL CLUES" << std::endl;
-    of << "\\begin{enumerate}" << std::endl;
-    for (auto i = 0; i <= grid->get_height(); i++)
-    {
-        for (auto j = 0; j <= grid->get_width(); j++)
-        {
-            Word const *vword = grid->get_word_starting_at(i, j, Direction::HORIZONTAL);
-            if (vword != nullptr)
-            {
-                of << "\\item " << vword->clue << std::endl;
-            }
-        }
-    }
-    of << "\\end{enumerate}" << std::endl;
-    of << "\\end{multicols*}" << std::endl;
+    doc += "\\begin{multicols*}{2}\n";
+    doc += "VERTICAL CLUES\n";
+    doc += "\\begin{enumerate}\n";
+    add_clues(Direction::VERTICAL);
+    doc += "\\end{enumerate}\n";
+    doc += "\\vfill\\null\n";
+    doc += "\\columnbreak\n";
+
+    doc += "HORIZONTAL CLUES\n";
+    doc += "\\begin{enumerate}\n";
+    add_clues(Direction::HORIZONTAL);
+    doc += "\\end{enumerate}\n";
+    doc += "\\end{multicols*}\n";
 }
 
-void LatexGenerator::add_pagebreak(std::ofstream &of) const
+void LatexGenerator::add_pagebreak(std::string &doc) const
 {
-    of << std::endl
-       << "\\pagebreak" << std::endl;
+    doc += "\n\\pagebreak\n";
 }
 
-void LatexGenerator::add_solutionmode(std::ofstream &of) const
+void LatexGenerator::add_solutionmode(std::string &doc) const
 {
-    of << std::endl
-       << "\\PuzzleSolution" << std::endl;
+    doc += "\n\\PuzzleSolution\n";
 }
 
-void LatexGenerator::add_closing(std::ofstream &of) const
+void LatexGenerator::add_closing(std::string &doc) const
 {
-    of << std::endl
-       << "\\end{document}" << std::endl;
+    doc += "\n\\end{document}\n";
+}
+
+LatexGenerator::RenderedPuzzle LatexGenerator::render(Grid const &grid) const
+{
+    RenderedPuzzle rendered;
+    // rough upper bound of a cell with markers, avoids most reallocations
+    rendered.puzzle.reserve((grid->get_height() + 1) * (grid->get_width() + 2) * 16);
+    add_puzzle(grid, rendered.puzzle);
+    add_hints(grid, rendered.hints);
+    return rendered;
+}
+
+void LatexGenerator::write_document(std::vector<RenderedPuzzle> const &puzzles, std::size_t first,
+                                    std::size_t last, std::string const &fileloc) const
+{
+    // the puzzles are contained twice, as puzzle and as solution
+    std::size_t size = 1024;
+    for (auto i = first; i < last; i++)
+    {
+        size += 2 * puzzles[i].puzzle.size() + puzzles[i].hints.size() + 64;
+    }
+    std::string doc;
+    doc.reserve(size);
+
+    add_preamble(doc);
+    add_puzzle_macros(doc);
+
+    for (auto i = first; i < last; i++)
+    {
+        doc += puzzles[i].puzzle;
+        add_pagebreak(doc);
+        doc += puzzles[i].hints;
+        add_pagebreak(doc);
+    }
+
+    add_solutionmode(doc);
+    for (auto i = first; i < last; i++)
+    {
+        if (i != first)
+            add_pagebreak(doc);
+        doc += puzzles[i].puzzle;
+    }
+
+    add_closing(doc);
+
+    std::ofstream of(fileloc, std::ios::binary);
+    of.write(doc.data(), doc.size());
+    if (!of)
+    {
+        throw std::runtime_error("Could not write LaTeX document '" + fileloc + "'!");
+    }
 }
 
 void LatexGenerator::generate(Grid const &grid, std::string const &fileloc) const
 {
-    std::ofstream of;
-    of.open(fileloc);
+    generate(std::vector<Grid>{grid}, fileloc);
+}
 
-    add_preamble(of);
-    add_puzzle_macros(of);
+std::vector<std::string> LatexGenerator::generate(std::vector<Grid> const &grids, std::string const &fileloc,
+                                                  std::size_t puzzles_per_document,
+                                                  int thread_count) const
+{
+    if (thread_count <= 0)
+    {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    thread_count = std::min<std::size_t>(thread_count, std::max<std::size_t>(grids.size(), 1));
 
-    add_puzzle(grid, of);
-    add_pagebreak(of);
-    add_hints(grid, of);
+    // puzzles are independent of each other, so they can be rendered in parallel
+    std::vector<RenderedPuzzle> puzzles(grids.size());
+    std::atomic<std::size_t> next_puzzle(0);
+    auto render_fun = [this, &grids, &puzzles, &next_puzzle]()
+    {
+        for (auto i = next_puzzle++; i < grids.size(); i = next_puzzle++)
+        {
+            puzzles[i] = render(grids[i]);
+        }
+    };
+    std::vector<std::thread> render_threads;
+    for (int i = 1; i < thread_count; i++)
+    {
+        render_threads.push_back(std::thread(render_fun));
+    }
+    render_fun();
+    for (auto &thread : render_threads)
+    {
+        thread.join();
+    }
 
-    add_pagebreak(of);
-    add_solutionmode(of);
-    add_puzzle(grid, of);
+    if (puzzles_per_document == 0 || puzzles_per_document >= grids.size())
+    {
+        write_document(puzzles, 0, puzzles.size(), fileloc);
+        return {fileloc};
+    }
+
+    // crossword.tex -> crossword_1.tex, crossword_2.tex, ...
+    std::size_t const extension = fileloc.rfind('.');
+    bool const has_extension = extension != std::string::npos && fileloc.find('/', extension) == std::string::npos;
+    std::string const stem = has_extension ? fileloc.substr(0, extension) : fileloc;
+    std::string const suffix = has_extension ? fileloc.substr(extension) : "";
 
-    add_closing(of);
-}
\ No newline at end of file
+    std::vector<std::string> documents;
+    for (std::size_t first = 0; first < puzzles.size(); first += puzzles_per_document)
+    {
+        documents.push_back(stem + "_" + std::to_string(documents.size() + 1) + suffix);
+        write_document(puzzles, first, std::min(first + puzzles_per_document, puzzles.size()),
+                       documents.back());
+    }
+    return documents;
+}
@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <string>
 
+#include "csvwordprovider.h"
 #include "generator.h"
 #include "latexgenerator.h"
 
@@ -14,10 +15,41 @@
 
 using namespace Crossword;
 
-int main(__attribute__((unused)) int argc, char *argv[])
+/**
+	Converts a CSV word list into a binary word list for the word provider of
+	type 'bin', which loads much faster.
+ */
+int convert_word_list(std::string const &csv_location, std::string const &binary_location)
+{
+	try
+	{
+		WordStore words;
+		CSVWordProvider(csv_location).retrieve_word_list(words);
+		words.save_binary(binary_location);
+		std::cout << "Converted " << words.size() << " words to " << binary_location << std::endl;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
 {
 	using namespace std::filesystem;
 
+	if (argc > 1 && std::string(argv[1]) == "convert")
+	{
+		if (argc != 4)
+		{
+			std::cerr << "Usage: " << argv[0] << " convert <csv word list> <binary word list>" << std::endl;
+			return -1;
+		}
+		return convert_word_list(argv[2], argv[3]);
+	}
+
 	std::cout << "Starting crossword generator." << std::endl;
 
 	path exec_path = argv[0];
@@ -48,7 +80,16 @@ int main(__attribute__((unused)) int argc, char *argv[])
 	std::string const wordprovider_type = reader.Get("wordlist", "type", "INVALID");
 	std::string const scorer_type = reader.Get("scoring", "type", "INVALID");
 
-	auto wordprovider = WordProvider::create(wordprovider_type, wordlistloc.string());
+	std::unique_ptr<WordProvider> wordprovider;
+	try
+	{
+		wordprovider = WordProvider::create(wordprovider_type, wordlistloc.string(), reader);
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return -1;
+	}
 	auto scorer = Scorer::create(scorer_type, reader);
 
 	if (wordprovider == nullptr)
@@ -65,13 +106,48 @@ int main(__attribute__((unused)) int argc, char *argv[])
 		return -1;
 	}
 
-	Generator generator(cw_gen_count, cw_max_width, cw_max_height,
-						std::move(wordprovider), std::move(scorer));
+	std::vector<Grid> grids;
+	try
+	{
+		Generator generator(cw_gen_count, cw_max_width, cw_max_height,
+							std::move(wordprovider), std::move(scorer), reader);
 
-	Grid grid = generator.generate();
+		grids = generator.generate();
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return -1;
+	}
+
+	if (grids.empty())
+	{
+		std::cerr << "Error: No crossword could be generated!" << std::endl;
+		return -1;
+	}
+
+	auto puzzle_count = reader.GetInteger("output", "puzzle_count", 1);
+	auto puzzles_per_document = reader.GetInteger("output", "puzzles_per_document", 0);
+	if (puzzle_count < 1 || puzzles_per_document < 0)
+	{
+		std::cerr << "Error reading output settings from config!" << std::endl;
+		return -1;
+	}
+	if (static_cast<std::size_t>(puzzle_count) > grids.size())
+	{
+		std::cerr << "Warning: Only " << grids.size() << " of " << puzzle_count
+				  << " puzzles available, increase best_grid_count!" << std::endl;
+		puzzle_count = grids.size();
+	}
+	grids.resize(puzzle_count);
 
 	LatexGenerator to_latex;
-	to_latex.generate(grid, "crossword.tex");
+	auto const documents = to_latex.generate(grids, reader.Get("output", "file", "crossword.tex"),
+											 puzzles_per_document, 0);
+	for (auto const &document : documents)
+	{
+		std::cout << "Wrote " << document << std::endl;
+	}
 
 	return 0;
 }
\ No newline at end of file
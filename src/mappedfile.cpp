@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mappedfile.h"
+
+using namespace Crossword;
+
+namespace
+{
+    std::runtime_error open_error(std::string const &location)
+    {
+        return std::runtime_error(
+            "Could not open the file! Does it exist?\n"
+            "(Filename: " +
+            location + ")");
+    }
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::string const &location, Access access) : m_data(nullptr), m_size(0)
+{
+    DWORD const flags = access == Access::RANDOM ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE const file = CreateFileA(location.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw open_error(location);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) ||
+        static_cast<std::uint64_t>(file_size.QuadPart) > std::numeric_limits<std::size_t>::max())
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Could not determine the size of file '" + location + "'!");
+    }
+
+    // mapping 0 bytes fails, empty files simply have no data
+    m_size = static_cast<std::size_t>(file_size.QuadPart);
+    if (m_size > 0)
+    {
+        HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void *const data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        // the view stays valid after closing the mapping and the file
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        if (data == nullptr)
+        {
+            CloseHandle(file);
+            throw std::runtime_error("Could not map file '" + location + "' into memory!");
+        }
+        m_data = static_cast<char const *>(data);
+    }
+    CloseHandle(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(std::string const &location, Access access) : m_data(nullptr), m_size(0)
+{
+    int const fd = open(location.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw open_error(location);
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("Could not determine the size of file '" + location + "'!");
+    }
+
+    // mapping 0 bytes fails, empty files simply have no data
+    m_size = file_stat.st_size;
+    if (m_size > 0)
+    {
+        void *const data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("Could not map file '" + location + "' into memory!");
+        }
+        madvise(data, m_size, access == Access::RANDOM ? MADV_RANDOM : MADV_SEQUENTIAL);
+        m_data = static_cast<char const *>(data);
+    }
+    // the mapping stays valid after closing the file
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<char *>(m_data), m_size);
+    }
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "mergedwordprovider.h"
+
+using namespace Crossword;
+
+namespace
+{
+    // first occurrence of a solution and its chosen clue
+    typedef struct MergedWord
+    {
+        WordView solution;
+        std::string_view clue;
+        // clues joined by ClueConflict::JOIN, empty if there was no conflict
+        std::string joined_clue;
+    } MergedWord;
+}
+
+MergedWordProvider::MergedWordProvider(std::vector<std::unique_ptr<WordProvider>> sources,
+                                       ClueConflict clue_conflict)
+    : m_sources(std::move(sources)), m_clue_conflict(clue_conflict)
+{
+    std::cout << "Initialized merged word list provider. "
+              << "Sources: " << m_sources.size() << std::endl;
+}
+
+MergedWordProvider::ClueConflict MergedWordProvider::parse_clue_conflict(std::string const &name)
+{
+    if (name == "first")
+        return ClueConflict::FIRST;
+    if (name == "last")
+        return ClueConflict::LAST;
+    if (name == "join")
+        return ClueConflict::JOIN;
+    if (name == "error")
+        return ClueConflict::ERROR;
+    throw std::runtime_error("Unknown clue conflict policy '" + name + "'");
+}
+
+void MergedWordProvider::retrieve_word_list(WordStore &words) const
+{
+    // the source stores own the letters and clues the merged words point to
+    std::vector<WordStore> source_words(m_sources.size());
+    std::size_t total_count = 0;
+    for (std::size_t source = 0; source < m_sources.size(); source++)
+    {
+        m_sources[source]->retrieve_word_list(source_words[source]);
+        total_count += source_words[source].size();
+    }
+
+    std::vector<MergedWord> merged;
+    std::unordered_map<std::string_view, std::size_t> merged_ids;
+    merged.reserve(total_count);
+    merged_ids.reserve(total_count);
+    for (WordStore const &store : source_words)
+    {
+        for (wid id = 0; id < store.size(); id++)
+        {
+            WordView const solution = store.get_word(id);
+            std::string_view const clue = store.get_clue(id);
+            auto const [it, inserted] = merged_ids.emplace(
+                std::string_view(solution.letters, solution.length), merged.size());
+            if (inserted)
+            {
+                merged.push_back({solution, clue, {}});
+                continue;
+            }
+
+            MergedWord &word = merged[it->second];
+            if (clue == word.clue)
+                continue;
+            switch (m_clue_conflict)
+            {
+            case ClueConflict::FIRST:
+                break;
+            case ClueConflict::LAST:
+                word.clue = clue;
+                break;
+            case ClueConflict::JOIN:
+                if (word.joined_clue.empty())
+                    word.joined_clue = word.clue;
+                // skip clues that were joined already
+                if ((" / " + word.joined_clue + " / ").find(" / " + std::string(clue) + " / ") == std::string::npos)
+                    word.joined_clue.append(" / ").append(clue);
+                break;
+            case ClueConflict::ERROR:
+                throw std::runtime_error("Conflicting clues '" + std::string(word.clue) + "' and '" +
+                                         std::string(clue) + "' for solution " + std::string(it->first));
+            }
+        }
+    }
+
+    for (MergedWord const &word : merged)
+    {
+        words.add(word.joined_clue.empty() ? word.clue : std::string_view(word.joined_clue),
+                  std::string_view(word.solution.letters, word.solution.length));
+    }
+
+    std::cout << "Merged " << total_count << " words into " << merged.size()
+              << " unique solutions." << std::endl;
+}
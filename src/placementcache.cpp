@@ -0,0 +1,149 @@
+#include <algorithm>
+
+#include "placementcache.h"
+
+using namespace Crossword;
+
+namespace
+{
+    // order of _Grid::get_valid_placements(...)
+    bool crossing_order(CrossingPlacement const &a, CrossingPlacement const &b)
+    {
+        if (a.offset != b.offset)
+            return a.offset < b.offset;
+        if (a.cell != b.cell)
+            return a.cell < b.cell;
+        return a.placement.direction() < b.placement.direction();
+    }
+}
+
+void PlacementCache::reset(std::size_t word_count)
+{
+    // keep the allocated memory of the placement vectors for the next grid
+    m_placements.resize(word_count);
+    for (wid const word : m_touched_words)
+    {
+        m_placements[word].clear();
+    }
+    m_touched_words.clear();
+    m_updated_placements.assign(word_count, 0);
+
+    m_placed_spans.clear();
+    m_new_letters.clear();
+    for (auto &cells : m_new_cells_by_letter)
+    {
+        cells.clear();
+    }
+    m_size_changed_placements = 0;
+    m_grid_height = 0;
+    m_grid_width = 0;
+}
+
+void PlacementCache::word_placed(_Grid const &grid, wid word, Placement placement)
+{
+    Location const loc = grid.to_location(placement);
+    gidx const length = grid.get_word_store().get_length(word);
+    // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
+    m_placed_spans.push_back({loc.row, loc.row + (length - 1) * (1 - loc.direction),
+                              loc.column, loc.column + (length - 1) * loc.direction});
+
+    m_new_cells.clear();
+    m_new_letters.push_back(grid.get_new_cells(placement, m_new_cells));
+    for (gidx const cell : m_new_cells)
+    {
+        unsigned char const code = grid.get_cell_letter(cell);
+        m_new_cells_by_letter[code].push_back({m_placed_spans.size() - 1, cell});
+    }
+
+    // growing the used part of the grid may move placements anywhere out of bounds
+    if (grid.get_height() != m_grid_height || grid.get_width() != m_grid_width)
+    {
+        m_size_changed_placements = m_placed_spans.size();
+        m_grid_height = grid.get_height();
+        m_grid_width = grid.get_width();
+    }
+}
+
+void PlacementCache::update(_Grid const &grid, wid word)
+{
+    std::size_t const updated = m_updated_placements[word];
+    if (updated == m_placed_spans.size())
+        return;
+    m_updated_placements[word] = m_placed_spans.size();
+
+    std::vector<CrossingPlacement> &placements = m_placements[word];
+    std::size_t const cached_count = placements.size();
+    if (updated == 0)
+    {
+        // first request, there is nothing to reuse
+        grid.get_valid_placements(word, placements);
+    }
+    else
+    {
+        WordStore const &word_store = grid.get_word_store();
+
+        // validate cached placements again
+        bool const size_changed = m_size_changed_placements > updated;
+        gidx const length = word_store.get_length(word);
+        auto is_affected = [&](Placement placement) {
+            if (size_changed)
+                return true;
+
+            // rectangle of the cells a placement depends on: its letters, the
+            // cells before and after it and its neighbours
+            Location const loc = grid.to_location(placement);
+            gidx const last_row = loc.row + (length - 1) * (1 - loc.direction);
+            gidx const last_column = loc.column + (length - 1) * loc.direction;
+            for (auto span = m_placed_spans.begin() + updated; span != m_placed_spans.end(); span++)
+            {
+                if (loc.row - 1 <= span->last_row && last_row + 1 >= span->first_row &&
+                    loc.column - 1 <= span->last_column && last_column + 1 >= span->first_column)
+                    return true;
+            }
+            return false;
+        };
+        // the features of a placement can only change if it is affected as well
+        auto kept = placements.begin();
+        for (CrossingPlacement &crossing : placements)
+        {
+            if (is_affected(crossing.placement) &&
+                !grid.is_valid_placement(word, crossing.placement, crossing.features))
+                continue;
+            *kept++ = crossing;
+        }
+        placements.erase(kept, placements.end());
+        std::size_t const kept_count = placements.size();
+
+        // add placements crossing the cells filled since the last update
+        letter_mask new_letters = 0;
+        for (std::size_t placed = updated; placed < m_placed_spans.size(); placed++)
+        {
+            new_letters |= m_new_letters[placed];
+        }
+        if ((new_letters & word_store.get_letter_mask(word)) != 0)
+        {
+            WordView const letters = word_store.get_word(word);
+            for (std::uint32_t offset = 0; offset < letters.length; offset++)
+            {
+                auto const &cells = m_new_cells_by_letter[static_cast<unsigned char>(letters[offset])];
+                auto const first = std::partition_point(cells.begin(), cells.end(),
+                                                        [updated](NewCell const &new_cell) { return new_cell.placed < updated; });
+                for (auto new_cell = first; new_cell != cells.end(); new_cell++)
+                {
+                    grid.get_crossing_placements(word, offset, new_cell->cell, placements);
+                }
+            }
+            std::sort(placements.begin() + kept_count, placements.end(), crossing_order);
+            std::inplace_merge(placements.begin(), placements.begin() + kept_count, placements.end(), crossing_order);
+        }
+    }
+
+    if (cached_count == 0 && !placements.empty())
+        m_touched_words.push_back(word);
+}
+
+std::vector<CrossingPlacement> const &PlacementCache::get_valid_placements(_Grid const &grid, wid word)
+{
+    update(grid, word);
+    return m_placements[word];
+}
@@ -0,0 +1,110 @@
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "placementstrategy.h"
+#include "heuristicstrategy.h"
+#include "randomstrategy.h"
+
+using namespace Crossword;
+
+PlacementStrategy::PlacementStrategy(INIReader const &config)
+    : m_crossing_factor(config.GetReal("placement", "crossing_factor", 4.0)),
+      m_growth_factor(config.GetReal("placement", "growth_factor", 0.5))
+{
+    std::string const choice = config.Get("placement", "choice", "uniform");
+    if (choice == "uniform")
+    {
+        m_weighted = false;
+    }
+    else if (choice == "weighted")
+    {
+        m_weighted = true;
+    }
+    else
+    {
+        throw std::runtime_error("Unknown placement choice '" + choice +
+                                 "'! Expected 'uniform' or 'weighted'.");
+    }
+    if (!(m_crossing_factor > 0.0) || !(m_growth_factor > 0.0))
+    {
+        throw std::runtime_error("crossing_factor and growth_factor must be greater than 0!");
+    }
+
+    if (m_weighted)
+    {
+        std::cout << "Placements are weighted. crossing_factor = " << m_crossing_factor
+                  << ", growth_factor = " << m_growth_factor << std::endl;
+    }
+}
+
+std::unique_ptr<PlacementStrategy> PlacementStrategy::create(std::string const &type, INIReader const &config,
+                                                             WordStore const &words, WordAnalysis const &analysis)
+{
+    if (type == "random")
+    {
+        return std::make_unique<RandomStrategy>(config);
+    }
+    if (type == "longest")
+    {
+        return std::make_unique<HeuristicStrategy>(HeuristicStrategy::Heuristic::LENGTH, 0.0, words, analysis, config);
+    }
+    if (type == "crossable")
+    {
+        return std::make_unique<HeuristicStrategy>(HeuristicStrategy::Heuristic::CROSSABILITY, 0.0, words, analysis, config);
+    }
+    if (type == "greedy")
+    {
+        std::string const heuristic = config.Get("placement", "heuristic", "crossable");
+        double const temperature = config.GetReal("placement", "temperature", 0.1);
+        if (!(temperature > 0.0))
+        {
+            throw std::runtime_error("temperature must be greater than 0!");
+        }
+        if (heuristic == "longest")
+        {
+            return std::make_unique<HeuristicStrategy>(HeuristicStrategy::Heuristic::LENGTH, temperature, words, analysis, config);
+        }
+        if (heuristic == "crossable")
+        {
+            return std::make_unique<HeuristicStrategy>(HeuristicStrategy::Heuristic::CROSSABILITY, temperature, words, analysis, config);
+        }
+        throw std::runtime_error("Unknown placement heuristic '" + heuristic +
+                                 "'! Expected 'longest' or 'crossable'.");
+    }
+    return nullptr;
+}
+
+wid PlacementStrategy::take_first_word(std::vector<wid> &words, Rng &rng) const
+{
+    order_words(words, rng);
+    wid const first_word = words.front();
+    // the remaining words are ordered again before every round
+    words.front() = words.back();
+    words.pop_back();
+    return first_word;
+}
+
+Placement PlacementStrategy::choose_placement(wid, std::vector<CrossingPlacement> const &placements,
+                                              Rng &rng) const
+{
+    if (!m_weighted)
+        return placements[rng.below(placements.size())].placement;
+
+    // A placement crossing k words is listed once per crossing, so each of its
+    // entries gets 1/k of its weight.
+    auto weight = [this](PlacementFeatures const &features) {
+        return std::pow(m_crossing_factor, features.crossings - 1) *
+               std::pow(m_growth_factor, features.added_rows + features.added_columns) /
+               features.crossings;
+    };
+    Reservoir<Placement, double> reservoir(rng);
+    for (CrossingPlacement const &crossing : placements)
+    {
+        reservoir.offer(crossing.placement, weight(crossing.features));
+    }
+    // all weights may underflow to 0 on huge grids
+    if (reservoir.empty())
+        return placements[rng.below(placements.size())].placement;
+    return reservoir.get();
+}
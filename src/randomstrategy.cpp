@@ -0,0 +1,23 @@
+#include <iostream>
+
+#include "randomstrategy.h"
+
+using namespace Crossword;
+
+RandomStrategy::RandomStrategy(INIReader const &config) : PlacementStrategy(config)
+{
+    std::cout << "Initialized random placement strategy." << std::endl;
+}
+
+void RandomStrategy::order_words(std::vector<wid> &words, Rng &rng) const
+{
+    rng.shuffle(words.begin(), words.end());
+}
+
+wid RandomStrategy::take_first_word(std::vector<wid> &words, Rng &rng) const
+{
+    rng.shuffle(words.begin(), words.end());
+    wid const first_word = words.back();
+    words.pop_back();
+    return first_word;
+}
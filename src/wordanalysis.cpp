@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <numeric>
+
+#include "wordanalysis.h"
+
+using namespace Crossword;
+
+namespace
+{
+    // number of words outside of the largest component listed by report(...)
+    constexpr std::size_t MAX_REPORTED_WORDS = 10;
+
+    wid find_root(std::vector<wid> &parents, wid word)
+    {
+        while (parents[word] != word)
+        {
+            // path halving
+            parents[word] = parents[parents[word]];
+            word = parents[word];
+        }
+        return word;
+    }
+}
+
+WordAnalysis::WordAnalysis(WordStore const &words, std::int_fast32_t max_length)
+    : m_max_length(max_length), m_too_long_count(0)
+{
+    m_letter_word_counts.fill(0);
+
+    // Union the words containing a letter with the first word containing it.
+    // last_words remembers the last word a letter was seen in, so that every
+    // distinct letter of a word is counted once.
+    std::vector<wid> parents(words.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    std::array<wid, LETTER_CODE_COUNT> first_words;
+    std::array<wid, LETTER_CODE_COUNT> last_words;
+    first_words.fill(WordStore::NO_WORD);
+    last_words.fill(WordStore::NO_WORD);
+    for (wid id = 0; id < words.size(); id++)
+    {
+        WordView const word = words.get_word(id);
+        if (word.length > m_max_length)
+        {
+            m_too_long_count++;
+            continue;
+        }
+        for (std::int_fast32_t i = 0; i < word.length; i++)
+        {
+            unsigned char const code = static_cast<unsigned char>(word[i]);
+            if (last_words[code] == id)
+                continue;
+            last_words[code] = id;
+            m_letter_word_counts[code]++;
+
+            if (first_words[code] == WordStore::NO_WORD)
+            {
+                first_words[code] = id;
+                continue;
+            }
+            wid const root = find_root(parents, id);
+            wid const first_root = find_root(parents, first_words[code]);
+            // keep the smaller id as root, so that numbering is deterministic
+            parents[std::max(root, first_root)] = std::min(root, first_root);
+        }
+    }
+
+    // crossability: every distinct letter is shared with all other words containing it
+    m_crossabilities.assign(words.size(), 0);
+    last_words.fill(WordStore::NO_WORD);
+    for (wid id = 0; id < words.size(); id++)
+    {
+        WordView const word = words.get_word(id);
+        if (word.length > m_max_length)
+            continue;
+        for (std::int_fast32_t i = 0; i < word.length; i++)
+        {
+            unsigned char const code = static_cast<unsigned char>(word[i]);
+            if (last_words[code] == id)
+                continue;
+            last_words[code] = id;
+            m_crossabilities[id] += m_letter_word_counts[code] - 1;
+        }
+    }
+
+    // number the components by descending size, ties by their smallest word
+    std::vector<std::size_t> root_sizes(words.size(), 0);
+    for (wid id = 0; id < words.size(); id++)
+    {
+        if (words.get_length(id) <= m_max_length)
+            root_sizes[find_root(parents, id)]++;
+    }
+    std::vector<wid> roots;
+    for (wid id = 0; id < words.size(); id++)
+    {
+        if (parents[id] == id && root_sizes[id] > 0)
+            roots.push_back(id);
+    }
+    std::stable_sort(roots.begin(), roots.end(), [&root_sizes](wid a, wid b)
+                     { return root_sizes[a] > root_sizes[b]; });
+
+    std::vector<std::uint32_t> root_components(words.size());
+    m_component_sizes.clear();
+    for (wid const root : roots)
+    {
+        root_components[root] = m_component_sizes.size();
+        m_component_sizes.push_back(root_sizes[root]);
+    }
+    m_components.resize(words.size());
+    for (wid id = 0; id < words.size(); id++)
+    {
+        m_components[id] = words.get_length(id) <= m_max_length ? root_components[find_root(parents, id)]
+                                                                : NO_COMPONENT;
+    }
+}
+
+std::vector<wid> WordAnalysis::get_component_words(std::uint32_t component) const
+{
+    std::vector<wid> component_words;
+    component_words.reserve(m_component_sizes[component]);
+    for (wid id = 0; id < m_components.size(); id++)
+    {
+        if (m_components[id] == component)
+            component_words.push_back(id);
+    }
+    return component_words;
+}
+
+void WordAnalysis::report(WordStore const &words, std::ostream &out) const
+{
+    out << "Word list analysis: " << words.size() << " words";
+    if (get_component_count() > 0)
+    {
+        std::uint64_t const total = std::accumulate(m_crossabilities.begin(), m_crossabilities.end(), std::uint64_t{0});
+        out << ", " << m_component_sizes[0] << " of them in the largest of "
+            << get_component_count() << " crossing component(s). "
+            << "Average crossability is " << total / words.size();
+    }
+    out << "." << std::endl;
+
+    if (m_too_long_count > 0)
+    {
+        out << m_too_long_count << " word(s) are longer than " << m_max_length
+            << " letters and can never be placed." << std::endl;
+    }
+    if (get_component_count() <= 1)
+        return;
+
+    std::size_t const unreachable = words.size() - m_too_long_count - m_component_sizes[0];
+    out << unreachable << " word(s) can never be crossed with the largest component:";
+    std::size_t listed = 0;
+    for (wid id = 0; id < words.size() && listed < MAX_REPORTED_WORDS; id++)
+    {
+        if (m_components[id] == 0 || m_components[id] == NO_COMPONENT)
+            continue;
+        out << " " << words.get_solution(id);
+        if (m_crossabilities[id] == 0)
+            out << " (no common letter)";
+        listed++;
+    }
+    if (unreachable > listed)
+        out << " ...";
+    out << std::endl;
+}
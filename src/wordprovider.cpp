@@ -1,14 +1,53 @@
+#include <filesystem>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
+#include "binarywordprovider.h"
 #include "csvwordprovider.h"
+#include "mergedwordprovider.h"
 
 using namespace Crossword;
 
-std::map<std::string, std::function<std::unique_ptr<WordProvider>(std::string)>> WordProvider::m_factories =
+std::map<std::string, std::function<std::unique_ptr<WordProvider>(std::string, INIReader const &)>> WordProvider::m_factories =
     {
-        {"csv", [](const std::string &location)
+        {"csv", [](const std::string &location, INIReader const &)
          {
              return std::make_unique<CSVWordProvider>(location);
+         }},
+        {"bin", [](const std::string &location, INIReader const &)
+         {
+             return std::make_unique<BinaryWordProvider>(location);
+         }},
+        // sources = <type>:<location>, ... with locations relative to location
+        {"merged", [](const std::string &location, INIReader const &config)
+         {
+             std::vector<std::unique_ptr<WordProvider>> sources;
+             std::string const list = config.Get("wordlist", "sources", "");
+             for (std::size_t begin = 0; begin < list.size();)
+             {
+                 std::size_t end = list.find(',', begin);
+                 if (end == std::string::npos)
+                     end = list.size();
+                 std::string const source = trim(list.substr(begin, end - begin));
+                 begin = end + 1;
+                 if (source.empty())
+                     continue;
+
+                 std::size_t const separator = source.find(':');
+                 std::string const type = separator == std::string::npos ? "" : trim(source.substr(0, separator));
+                 if (type.empty() || type == "merged" || m_factories.count(type) == 0)
+                     throw std::runtime_error("Invalid word list source '" + source + "'");
+                 std::filesystem::path const source_location =
+                     std::filesystem::path(location) / trim(source.substr(separator + 1));
+                 sources.push_back(m_factories[type](source_location.string(), config));
+             }
+             if (sources.empty())
+                 throw std::runtime_error("No word list sources to merge");
+
+             return std::make_unique<MergedWordProvider>(
+                 std::move(sources),
+                 MergedWordProvider::parse_clue_conflict(config.Get("wordlist", "clue_conflict", "first")));
          }}};
 
 std::string WordProvider::trim(std::string const &str)
@@ -16,17 +55,18 @@ std::string WordProvider::trim(std::string const &str)
     size_t first = str.find_first_not_of(' ');
     if (std::string::npos == first)
     {
-        return str;
+        return "";
     }
     size_t last = str.find_last_not_of(' ');
     return str.substr(first, (last - first + 1));
 }
 
-std::unique_ptr<WordProvider> WordProvider::create(const std::string &type, const std::string &location)
+std::unique_ptr<WordProvider> WordProvider::create(const std::string &type, const std::string &location,
+                                                   INIReader const &config)
 {
     if (m_factories.count(type) > 0)
     {
-        return m_factories[type](location);
+        return m_factories[type](location, config);
     }
     else
     {
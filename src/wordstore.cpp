@@ -0,0 +1,366 @@
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "wordstore.h"
+
+using namespace Crossword;
+
+namespace
+{
+    /**
+        Binary word list format: the header is followed by the arrays of the word
+        store in the order of BinaryLayout, each starting at a multiple of 8 bytes.
+        Numbers are stored in the byte order of the writing machine, which is
+        checked by the byte_order field.
+     */
+    constexpr char BINARY_MAGIC[8] = {'C', 'W', 'W', 'O', 'R', 'D', 'S', '\0'};
+    constexpr std::uint32_t BINARY_VERSION = 2;
+    constexpr std::uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+    typedef struct BinaryHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint64_t word_count;
+        std::uint64_t letter_count;
+        std::uint64_t clue_letter_count;
+    } BinaryHeader;
+
+    // byte offsets of the arrays in the file
+    typedef struct BinaryLayout
+    {
+        std::uint64_t offsets;
+        std::uint64_t lengths;
+        std::uint64_t letter_masks;
+        std::uint64_t clue_offsets;
+        std::uint64_t letters;
+        std::uint64_t clue_letters;
+        std::uint64_t file_size;
+    } BinaryLayout;
+
+    std::uint64_t align(std::uint64_t position)
+    {
+        return (position + 7) / 8 * 8;
+    }
+
+    /**
+        Computes the positions of the arrays for the counts of header.
+        @return false if the file size does not fit into 64 bits, i.e. the counts
+        are corrupt.
+     */
+    bool get_layout(BinaryHeader const &header, BinaryLayout &layout)
+    {
+        constexpr std::uint64_t max_size = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t end = sizeof(BinaryHeader);
+        // places an array of count elements of element_size bytes behind the previous one
+        auto place = [&end](std::uint64_t &position, std::uint64_t count, std::uint64_t element_size)
+        {
+            if (end > max_size - 7 || count > (max_size - align(end)) / element_size)
+                return false;
+            position = align(end);
+            end = position + count * element_size;
+            return true;
+        };
+        bool const fits = header.word_count < max_size &&
+                          place(layout.offsets, header.word_count, sizeof(std::uint32_t)) &&
+                          place(layout.lengths, header.word_count, sizeof(std::uint16_t)) &&
+                          place(layout.letter_masks, header.word_count, sizeof(letter_mask)) &&
+                          place(layout.clue_offsets, header.word_count + 1, sizeof(std::uint64_t)) &&
+                          place(layout.letters, header.letter_count, sizeof(char)) &&
+                          place(layout.clue_letters, header.clue_letter_count, sizeof(char));
+        layout.file_size = end;
+        return fits;
+    }
+}
+
+WordStore::WordStore() : m_clue_offsets(1, 0)
+{
+    update_views();
+}
+
+WordStore::WordStore(WordStore const &other)
+    : m_letters(other.m_letters), m_offsets(other.m_offsets), m_lengths(other.m_lengths),
+      m_letter_masks(other.m_letter_masks), m_clue_letters(other.m_clue_letters),
+      m_clue_offsets(other.m_clue_offsets), m_mapping(other.m_mapping)
+{
+    if (m_mapping)
+    {
+        // mapped arrays are shared, owned arrays are copied
+        m_letters_view = other.m_letters_view;
+        m_offsets_view = other.m_offsets_view;
+        m_lengths_view = other.m_lengths_view;
+        m_letter_masks_view = other.m_letter_masks_view;
+        m_clue_letters_view = other.m_clue_letters_view;
+        m_clue_offsets_view = other.m_clue_offsets_view;
+    }
+    else
+    {
+        update_views();
+    }
+}
+
+WordStore::WordStore(WordStore &&other) noexcept : WordStore()
+{
+    *this = std::move(other);
+}
+
+WordStore &WordStore::operator=(WordStore const &other)
+{
+    if (this != &other)
+    {
+        *this = WordStore(other);
+    }
+    return *this;
+}
+
+WordStore &WordStore::operator=(WordStore &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    // moving the vectors keeps their memory, so the views stay valid
+    m_letters = std::move(other.m_letters);
+    m_offsets = std::move(other.m_offsets);
+    m_lengths = std::move(other.m_lengths);
+    m_letter_masks = std::move(other.m_letter_masks);
+    m_clue_letters = std::move(other.m_clue_letters);
+    m_clue_offsets = std::move(other.m_clue_offsets);
+    m_letters_view = other.m_letters_view;
+    m_offsets_view = other.m_offsets_view;
+    m_lengths_view = other.m_lengths_view;
+    m_letter_masks_view = other.m_letter_masks_view;
+    m_clue_letters_view = other.m_clue_letters_view;
+    m_clue_offsets_view = other.m_clue_offsets_view;
+    m_mapping = std::move(other.m_mapping);
+
+    // leave other empty
+    other.m_letters.clear();
+    other.m_offsets.clear();
+    other.m_lengths.clear();
+    other.m_letter_masks.clear();
+    other.m_clue_letters.clear();
+    other.m_clue_offsets.assign(1, 0);
+    other.m_mapping.reset();
+    other.update_views();
+    return *this;
+}
+
+void WordStore::update_views()
+{
+    m_letters_view = {m_letters.data(), m_letters.size()};
+    m_offsets_view = {m_offsets.data(), m_offsets.size()};
+    m_lengths_view = {m_lengths.data(), m_lengths.size()};
+    m_letter_masks_view = {m_letter_masks.data(), m_letter_masks.size()};
+    m_clue_letters_view = {m_clue_letters.data(), m_clue_letters.size()};
+    m_clue_offsets_view = {m_clue_offsets.data(), m_clue_offsets.size()};
+}
+
+void WordStore::make_owned()
+{
+    if (!m_mapping)
+        return;
+
+    auto copy = [](auto const &view, auto &vector)
+    {
+        vector.assign(view.data, view.data + view.size);
+    };
+    copy(m_letters_view, m_letters);
+    copy(m_offsets_view, m_offsets);
+    copy(m_lengths_view, m_lengths);
+    copy(m_letter_masks_view, m_letter_masks);
+    copy(m_clue_letters_view, m_clue_letters);
+    copy(m_clue_offsets_view, m_clue_offsets);
+    m_mapping.reset();
+    update_views();
+}
+
+void WordStore::reserve(std::size_t word_count, std::size_t letter_count)
+{
+    make_owned();
+    m_letters.reserve(letter_count);
+    m_offsets.reserve(word_count);
+    m_lengths.reserve(word_count);
+    m_letter_masks.reserve(word_count);
+    m_clue_offsets.reserve(word_count + 1);
+    update_views();
+}
+
+wid WordStore::add(std::string_view clue, std::string_view solution)
+{
+    if (size() >= NO_WORD)
+    {
+        throw std::length_error("Too many words in word store!");
+    }
+    if (solution.length() > std::numeric_limits<std::uint16_t>::max())
+    {
+        throw std::length_error("Solution '" + std::string(solution) + "' is too long!");
+    }
+    if (m_letters_view.size + solution.length() > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::length_error("Too many letters in word store!");
+    }
+
+    letter_mask mask = 0;
+    for (char const letter : solution)
+    {
+        mask |= get_letter_bit(letter);
+    }
+
+    make_owned();
+    wid const id = size();
+    m_offsets.push_back(m_letters.size());
+    m_lengths.push_back(solution.length());
+    m_letter_masks.push_back(mask);
+    m_letters.insert(m_letters.end(), solution.begin(), solution.end());
+    m_clue_letters.insert(m_clue_letters.end(), clue.begin(), clue.end());
+    m_clue_offsets.push_back(m_clue_letters.size());
+    update_views();
+
+    return id;
+}
+
+void WordStore::append(WordStore &&part)
+{
+    if (size() + part.size() >= NO_WORD)
+    {
+        throw std::length_error("Too many words in word store!");
+    }
+    if (m_letters_view.size + part.m_letters_view.size > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::length_error("Too many letters in word store!");
+    }
+
+    make_owned();
+    std::uint32_t const letter_base = m_letters.size();
+    std::uint64_t const clue_base = m_clue_letters.size();
+    m_offsets.reserve(m_offsets.size() + part.size());
+    m_clue_offsets.reserve(m_clue_offsets.size() + part.size());
+    for (wid id = 0; id < part.size(); id++)
+    {
+        m_offsets.push_back(letter_base + part.m_offsets_view[id]);
+        m_clue_offsets.push_back(clue_base + part.m_clue_offsets_view[id + 1]);
+    }
+    auto append_view = [](auto const &view, auto &vector)
+    {
+        vector.insert(vector.end(), view.data, view.data + view.size);
+    };
+    append_view(part.m_letters_view, m_letters);
+    append_view(part.m_lengths_view, m_lengths);
+    append_view(part.m_letter_masks_view, m_letter_masks);
+    append_view(part.m_clue_letters_view, m_clue_letters);
+    update_views();
+
+    part = WordStore();
+}
+
+std::string WordStore::get_solution(wid id) const
+{
+    WordView const word = get_word(id);
+    return std::string(word.letters, word.length);
+}
+
+void WordStore::save_binary(std::string const &location) const
+{
+    BinaryHeader header = {};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.byte_order = BINARY_BYTE_ORDER;
+    header.word_count = size();
+    header.letter_count = m_letters_view.size;
+    header.clue_letter_count = m_clue_letters_view.size;
+    BinaryLayout layout;
+    if (!get_layout(header, layout))
+    {
+        throw std::runtime_error("Too many words for binary word list '" + location + "'!");
+    }
+
+    std::ofstream file(location, std::ios::binary);
+    auto write_at = [&file](std::uint64_t position, void const *data, std::size_t size)
+    {
+        // pad up to the start of the array
+        static constexpr char padding[8] = {};
+        file.write(padding, position - file.tellp());
+        file.write(static_cast<char const *>(data), size);
+    };
+    write_at(0, &header, sizeof(header));
+    write_at(layout.offsets, m_offsets_view.data, m_offsets_view.size * sizeof(std::uint32_t));
+    write_at(layout.lengths, m_lengths_view.data, m_lengths_view.size * sizeof(std::uint16_t));
+    write_at(layout.letter_masks, m_letter_masks_view.data, m_letter_masks_view.size * sizeof(letter_mask));
+    write_at(layout.clue_offsets, m_clue_offsets_view.data, m_clue_offsets_view.size * sizeof(std::uint64_t));
+    write_at(layout.letters, m_letters_view.data, m_letters_view.size);
+    write_at(layout.clue_letters, m_clue_letters_view.data, m_clue_letters_view.size);
+
+    if (!file)
+    {
+        throw std::runtime_error("Could not write binary word list '" + location + "'!");
+    }
+}
+
+WordStore WordStore::load_binary(std::string const &location)
+{
+    // words are looked up by id, not read from start to end
+    auto mapping = std::make_shared<MappedFile const>(location, MappedFile::Access::RANDOM);
+    std::string_view const data = mapping->get_data();
+
+    BinaryHeader header;
+    if (data.size() < sizeof(header))
+    {
+        throw std::runtime_error("'" + location + "' is no binary word list!");
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw std::runtime_error("'" + location + "' is no binary word list!");
+    }
+    if (header.version != BINARY_VERSION || header.byte_order != BINARY_BYTE_ORDER)
+    {
+        throw std::runtime_error("Binary word list '" + location + "' was written by a different "
+                                 "version or on a machine of different byte order. Convert it again!");
+    }
+    BinaryLayout layout;
+    if (header.word_count >= NO_WORD || !get_layout(header, layout))
+    {
+        throw std::runtime_error("Binary word list '" + location + "' is corrupt!");
+    }
+    if (data.size() < layout.file_size)
+    {
+        throw std::runtime_error("Binary word list '" + location + "' is truncated!");
+    }
+
+    // the mapping starts at a page boundary and all arrays are aligned
+    auto view = [&data](auto &array_view, std::uint64_t position, std::uint64_t size)
+    {
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(array_view.data)>>;
+        array_view.data = reinterpret_cast<T const *>(data.data() + position);
+        array_view.size = size;
+    };
+    WordStore words;
+    view(words.m_letters_view, layout.letters, header.letter_count);
+    view(words.m_offsets_view, layout.offsets, header.word_count);
+    view(words.m_lengths_view, layout.lengths, header.word_count);
+    view(words.m_letter_masks_view, layout.letter_masks, header.word_count);
+    view(words.m_clue_letters_view, layout.clue_letters, header.clue_letter_count);
+    view(words.m_clue_offsets_view, layout.clue_offsets, header.word_count + 1);
+    words.m_mapping = std::move(mapping);
+
+    // all words and clues have to lie within their arenas, so no getter reads
+    // outside of the mapping
+    bool valid = words.m_clue_offsets_view[0] == 0 &&
+                 words.m_clue_offsets_view[header.word_count] == header.clue_letter_count;
+    for (wid id = 0; valid && id < header.word_count; id++)
+    {
+        valid = words.m_lengths_view[id] <= header.letter_count &&
+                words.m_offsets_view[id] <= header.letter_count - words.m_lengths_view[id] &&
+                words.m_clue_offsets_view[id] <= words.m_clue_offsets_view[id + 1];
+    }
+    if (!valid)
+    {
+        throw std::runtime_error("Binary word list '" + location + "' is corrupt!");
+    }
+    return words;
+}
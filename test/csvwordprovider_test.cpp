@@ -0,0 +1,85 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "csvwordprovider.h"
+#include "wordstore.h"
+
+using namespace Crossword;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, std::string const &message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << std::endl;
+            failures++;
+        }
+    }
+
+    void check_equal(WordStore const &expected, WordStore const &actual, std::string const &message)
+    {
+        check(expected.size() == actual.size(), message + ": word count");
+        for (wid id = 0; id < expected.size() && id < actual.size(); id++)
+        {
+            check(expected.get_solution(id) == actual.get_solution(id), message + ": solution of word " + std::to_string(id));
+            check(expected.get_clue(id) == actual.get_clue(id), message + ": clue of word " + std::to_string(id));
+        }
+    }
+
+    /**
+        A quoted multi-line clue in the middle of the file contains the line
+        breaks at which the file is split into two chunks. The second chunk
+        starts parsing inside the clue and has to be parsed again from the end
+        of the first one.
+     */
+    void test_quoted_record_across_chunk_boundary(std::string const &location)
+    {
+        std::string clue;
+        for (int i = 0; i < 100; i++)
+        {
+            clue += "line " + std::to_string(i) + ", \"\"quoted\"\"\n";
+        }
+        {
+            std::ofstream csv(location, std::ios::binary);
+            csv << "clue,word\n"
+                << "First,one\n"
+                << "\"" << clue << "\",multi\n"
+                << "Last,two\n";
+        }
+
+        CSVWordProvider const provider(location);
+        WordStore sequential;
+        provider.retrieve_word_list(sequential, 1);
+        check(sequential.size() == 3, "sequential: word count");
+        check(sequential.get_solution(1) == "MULTI", "sequential: solution of the multi-line record");
+        check(sequential.get_clue(1).size() == clue.size() - 200, "sequential: clue of the multi-line record");
+
+        for (std::size_t chunk_count = 2; chunk_count <= 8; chunk_count++)
+        {
+            WordStore chunked;
+            provider.retrieve_word_list(chunked, chunk_count);
+            check_equal(sequential, chunked, std::to_string(chunk_count) + " chunks");
+        }
+    }
+}
+
+int main()
+{
+    std::string const location = (std::filesystem::temp_directory_path() / "csvwordprovider_test.csv").string();
+    test_quoted_record_across_chunk_boundary(location);
+    std::filesystem::remove(location);
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
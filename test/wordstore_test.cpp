@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "wordstore.h"
+
+using namespace Crossword;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, std::string const &message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << std::endl;
+            failures++;
+        }
+    }
+
+    // position of the word count in the header and of the first word's offset behind it
+    constexpr std::streamoff WORD_COUNT_POSITION = 16;
+    constexpr std::streamoff FIRST_OFFSET_POSITION = 40;
+
+    template <typename T>
+    void overwrite(std::string const &location, std::streamoff position, T value)
+    {
+        std::fstream file(location, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(position);
+        file.write(reinterpret_cast<char const *>(&value), sizeof(value));
+    }
+
+    bool loads(std::string const &location)
+    {
+        try
+        {
+            WordStore::load_binary(location);
+            return true;
+        }
+        catch (std::runtime_error const &)
+        {
+            return false;
+        }
+    }
+
+    void test_round_trip(std::string const &location)
+    {
+        WordStore words;
+        words.add("First clue", "ONE");
+        words.add("Second clue", "TWO");
+        words.save_binary(location);
+
+        WordStore const loaded = WordStore::load_binary(location);
+        check(loaded.size() == 2, "round trip: word count");
+        check(loaded.get_solution(1) == "TWO", "round trip: solution");
+        check(loaded.get_clue(0) == "First clue", "round trip: clue");
+    }
+
+    void test_corrupt_files(std::string const &location)
+    {
+        WordStore words;
+        words.add("First clue", "ONE");
+        words.add("Second clue", "TWO");
+
+        // the layout of a huge word count overflows 64 bits
+        words.save_binary(location);
+        overwrite<std::uint64_t>(location, WORD_COUNT_POSITION, std::uint64_t{1} << 62);
+        check(!loads(location), "huge word count is rejected");
+
+        // the first word lies behind the letters
+        words.save_binary(location);
+        overwrite<std::uint32_t>(location, FIRST_OFFSET_POSITION, 5);
+        check(!loads(location), "word behind the letters is rejected");
+        overwrite<std::uint32_t>(location, FIRST_OFFSET_POSITION, 0xFFFFFFFF);
+        check(!loads(location), "wrapping word offset is rejected");
+
+        // the clue offsets follow the offsets, lengths and letter masks of both words
+        std::streamoff const clue_offsets_position = FIRST_OFFSET_POSITION + 8 + 8 + 8;
+        words.save_binary(location);
+        overwrite<std::uint64_t>(location, clue_offsets_position + 8, 25);
+        check(!loads(location), "decreasing clue offsets are rejected");
+
+        words.save_binary(location);
+        check(loads(location), "valid file is accepted");
+    }
+}
+
+int main()
+{
+    std::string const location = (std::filesystem::temp_directory_path() / "wordstore_test.bin").string();
+    test_round_trip(location);
+    test_corrupt_files(location);
+    std::filesystem::remove(location);
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}